@@ -0,0 +1,376 @@
+// Throughput, construction cost and memory footprint of the automata, built by compile_bench.sh.
+// Prints one CSV row per measurement so that the output of two releases can be diffed:
+//   benchmark,instance,alphabet,states,operations,seconds,operations_per_second,heap_bytes,checksum
+// seconds is the fastest of --repeat runs, heap_bytes is the heap growth while building
+// the instance (construction rows only, -1 where glibc cannot report it) and checksum
+// counts accepted inputs, it must not change between releases for the same seed.
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "NAutomatonBuilder.hpp"
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/dynamic_bitset.hpp>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define FACORE_BENCH_HEAP_BYTES
+#endif
+
+using namespace FACore;
+using namespace std;
+
+struct Options {
+    unsigned int alphabet = 2;
+    unsigned int states = 256;
+    unsigned int arcsPerLabel = 2;
+    unsigned int words = 1000;
+    unsigned int length = 32;
+    unsigned int repeat = 3;
+    unsigned int seed = 1;
+    // The bit parallel masks take ALPHABET_SIZE * n * n bits
+    unsigned int maxBitParallelStates = 4096;
+};
+
+static long long HeapBytes() {
+#ifdef FACORE_BENCH_HEAP_BYTES
+    return static_cast<long long>(mallinfo2().uordblks);
+#else
+    return -1;
+#endif
+}
+
+static void PrintRow(const string &benchmark, const string &instance, const Options &options,
+                     unsigned long long operations, double seconds, long long heapBytes, unsigned long long checksum) {
+    cout << benchmark << ',' << instance << ',' << options.alphabet << ',' << options.states << ','
+         << operations << ',' << seconds << ',' << (seconds > 0 ? operations / seconds : 0) << ','
+         << heapBytes << ',' << checksum << '\n';
+}
+
+// Runs body options.repeat times and returns the fastest run, body returns the checksum.
+// setup is called before every run and is not timed.
+template<class Setup, class Body>
+double Fastest(const Options &options, Setup setup, Body body, unsigned long long &checksum) {
+    double best = -1;
+    for(unsigned int run = 0; run < options.repeat; run++) {
+        setup();
+        auto start = chrono::steady_clock::now();
+        checksum = body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if(best < 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+template<class Body>
+double Fastest(const Options &options, Body body, unsigned long long &checksum) {
+    return Fastest(options, []() {}, body, checksum);
+}
+
+// Random total DFA, about half of the states final
+template<unsigned int ALPHABET_SIZE>
+DAutomaton<ALPHABET_SIZE>* RandomDFA(const Options &options, mt19937 &random) {
+    DAutomaton<ALPHABET_SIZE> *dfa = new DAutomaton<ALPHABET_SIZE>();
+    for(unsigned int state = 0; state < options.states; state++) {
+        dfa->AddState(random() % 2 == 0);
+    }
+    for(unsigned int state = 0; state < options.states; state++) {
+        for(unsigned int label = 0; label < ALPHABET_SIZE; label++) {
+            dfa->SetArc(state, label, random() % options.states);
+        }
+    }
+    return dfa;
+}
+
+// Every label moves to the next state of one random cycle, so consecutive steps touch
+// unrelated rows of the table and no input ever dies early
+template<unsigned int ALPHABET_SIZE>
+DAutomaton<ALPHABET_SIZE>* ScatteredCycleDFA(const Options &options, mt19937 &random) {
+    vector<unsigned int> order(options.states);
+    for(unsigned int state = 0; state < options.states; state++) {
+        order[state] = state;
+    }
+    shuffle(order.begin(), order.end(), random);
+    
+    DAutomaton<ALPHABET_SIZE> *dfa = new DAutomaton<ALPHABET_SIZE>();
+    for(unsigned int state = 0; state < options.states; state++) {
+        dfa->AddState(state % 3 == 0);
+    }
+    for(unsigned int position = 0; position < options.states; position++) {
+        for(unsigned int label = 0; label < ALPHABET_SIZE; label++) {
+            dfa->SetArc(order[position], label, order[(position + 1) % options.states]);
+        }
+    }
+    return dfa;
+}
+
+// options.arcsPerLabel random arcs out of every state and label
+template<unsigned int ALPHABET_SIZE>
+NAutomaton<ALPHABET_SIZE>* RandomNFA(const Options &options, mt19937 &random) {
+    NAutomatonBuilder<ALPHABET_SIZE> builder;
+    for(unsigned int state = 0; state < options.states; state++) {
+        builder.AddState(random() % 8 == 0);
+    }
+    for(unsigned int state = 0; state < options.states; state++) {
+        for(unsigned int label = 0; label < ALPHABET_SIZE; label++) {
+            for(unsigned int arc = 0; arc < options.arcsPerLabel; arc++) {
+                builder.AddArc(state, label, random() % options.states);
+            }
+        }
+    }
+    return new NAutomaton<ALPHABET_SIZE>(builder.Freeze());
+}
+
+// The symbol options.states - 1 places from the end is label 1: its minimal DFA has
+// 2^(states - 1) states, which defeats the lazy DFA cache, and in the other modes
+// every state ends up active
+template<unsigned int ALPHABET_SIZE>
+NAutomaton<ALPHABET_SIZE>* KthFromLastNFA(const Options &options, mt19937 &) {
+    NAutomatonBuilder<ALPHABET_SIZE> builder;
+    for(unsigned int state = 0; state < options.states; state++) {
+        builder.AddState(state + 1 == options.states);
+    }
+    for(unsigned int label = 0; label < ALPHABET_SIZE; label++) {
+        builder.AddArc(0, label, 0);
+    }
+    if(options.states > 1) {
+        builder.AddArc(0, 1, 1);
+    }
+    for(unsigned int state = 1; state + 1 < options.states; state++) {
+        for(unsigned int label = 0; label < ALPHABET_SIZE; label++) {
+            builder.AddArc(state, label, state + 1);
+        }
+    }
+    return new NAutomaton<ALPHABET_SIZE>(builder.Freeze());
+}
+
+template<unsigned int ALPHABET_SIZE>
+vector<vector<unsigned int> > RandomWords(const Options &options, mt19937 &random) {
+    vector<vector<unsigned int> > words(options.words, vector<unsigned int>(options.length));
+    for(vector<unsigned int> &word : words) {
+        for(unsigned int &label : word) {
+            label = random() % ALPHABET_SIZE;
+        }
+    }
+    return words;
+}
+
+static vector<uint64_t> RandomNumbers(const Options &options, mt19937 &random) {
+    vector<uint64_t> numbers(options.words);
+    for(uint64_t &number : numbers) {
+        number = (static_cast<uint64_t>(random()) << 32) | random();
+    }
+    return numbers;
+}
+
+// contains over words, over unsigned int and over uint64_t inputs. makeLanguage returns a
+// unique_ptr to the language. With freshPerRun it is called again before every run, so that
+// state kept by the language across queries, such as the lazy DFA cache, starts out cold.
+template<class MakeLanguage>
+void MeasureContains(const string &instance, MakeLanguage makeLanguage, bool freshPerRun, const vector<vector<unsigned int> > &words, const vector<uint64_t> &numbers, const Options &options) {
+    auto language = makeLanguage();
+    auto setup = [&]() {
+        if(freshPerRun) {
+            language = makeLanguage();
+        }
+    };
+    
+    unsigned long long checksum = 0;
+    double seconds = Fastest(options, setup, [&]() {
+        unsigned long long accepted = 0;
+        for(const vector<unsigned int> &word : words) {
+            accepted += language->contains(word.begin(), word.end());
+        }
+        return accepted;
+    }, checksum);
+    PrintRow("contains_iterator", instance, options, static_cast<unsigned long long>(options.words) * options.length, seconds, 0, checksum);
+    
+    seconds = Fastest(options, setup, [&]() {
+        unsigned long long accepted = 0;
+        for(uint64_t number : numbers) {
+            accepted += language->contains(static_cast<unsigned int>(number));
+        }
+        return accepted;
+    }, checksum);
+    PrintRow("contains_integer", instance, options, numbers.size(), seconds, 0, checksum);
+    
+    seconds = Fastest(options, setup, [&]() {
+        unsigned long long accepted = 0;
+        for(uint64_t number : numbers) {
+            accepted += language->containsNumber(number);
+        }
+        return accepted;
+    }, checksum);
+    PrintRow("contains_uint64", instance, options, numbers.size(), seconds, 0, checksum);
+}
+
+template<unsigned int ALPHABET_SIZE, class Generator>
+void BenchmarkDFA(const string &instance, Generator generator, const Options &options) {
+    typedef DAutomaton<ALPHABET_SIZE> Machine;
+    
+    // Construction is timed with the generator's random draws included, they are the same for every release
+    unsigned long long checksum = 0;
+    long long heapBytes = -1;
+    double seconds = Fastest(options, [&]() {
+        mt19937 random(options.seed);
+        long long before = HeapBytes();
+        unique_ptr<Machine> dfa(generator(options, random));
+        heapBytes = before < 0 ? -1 : HeapBytes() - before;
+        return static_cast<unsigned long long>(dfa->GetNumStates());
+    }, checksum);
+    PrintRow("construct_setarc", instance, options, static_cast<unsigned long long>(options.states) * ALPHABET_SIZE, seconds, heapBytes, checksum);
+    
+    mt19937 random(options.seed);
+    shared_ptr<const Machine> dfa(generator(options, random));
+    DRegularLanguage<ALPHABET_SIZE> language(dfa, 0);
+    const vector<vector<unsigned int> > words = RandomWords<ALPHABET_SIZE>(options, random);
+    const vector<uint64_t> numbers = RandomNumbers(options, random);
+    MeasureContains(instance, [&]() { return unique_ptr<DRegularLanguage<ALPHABET_SIZE> >(new DRegularLanguage<ALPHABET_SIZE>(dfa, 0)); }, false, words, numbers, options);
+    
+    vector<unsigned int> narrowNumbers(numbers.begin(), numbers.end());
+    boost::dynamic_bitset<> out;
+    seconds = Fastest(options, [&]() {
+        language.containsBatch(narrowNumbers.data(), narrowNumbers.size(), out);
+        return static_cast<unsigned long long>(out.count());
+    }, checksum);
+    PrintRow("contains_batch", instance, options, narrowNumbers.size(), seconds, 0, checksum);
+}
+
+template<unsigned int ALPHABET_SIZE, class Generator>
+void BenchmarkNFA(const string &instance, Generator generator, const Options &options) {
+    typedef NAutomaton<ALPHABET_SIZE> Machine;
+    
+    unsigned long long checksum = 0;
+    long long heapBytes = -1;
+    double seconds = Fastest(options, [&]() {
+        mt19937 random(options.seed);
+        long long before = HeapBytes();
+        unique_ptr<Machine> nfa(generator(options, random));
+        heapBytes = before < 0 ? -1 : HeapBytes() - before;
+        return static_cast<unsigned long long>(nfa->GetNumStates());
+    }, checksum);
+    PrintRow("construct_builder", instance, options, static_cast<unsigned long long>(options.states) * ALPHABET_SIZE * options.arcsPerLabel, seconds, heapBytes, checksum);
+    
+    mt19937 random(options.seed);
+    shared_ptr<const Machine> nfa(generator(options, random));
+    const vector<vector<unsigned int> > words = RandomWords<ALPHABET_SIZE>(options, random);
+    const vector<uint64_t> numbers = RandomNumbers(options, random);
+    
+    typedef NRegularLanguage<ALPHABET_SIZE> Language;
+    auto makeLanguage = [&](SimulationMode mode) {
+        return [&nfa, mode]() { return unique_ptr<Language>(new Language(nfa, {0}, mode)); };
+    };
+    
+    MeasureContains(instance + "/state_set", makeLanguage(SimulationMode::StateSet), false, words, numbers, options);
+    
+    // A warm cache from an earlier run would hide the cost of filling it
+    MeasureContains(instance + "/lazy_dfa", makeLanguage(SimulationMode::LazyDFA), true, words, numbers, options);
+    
+    if(options.states <= options.maxBitParallelStates) {
+        long long before = HeapBytes();
+        unique_ptr<Language> bitParallel = makeLanguage(SimulationMode::BitParallel)();
+        PrintRow("bit_parallel_masks", instance, options, 0, 0, before < 0 ? -1 : HeapBytes() - before, 0);
+        MeasureContains(instance + "/bit_parallel", [&]() { return std::move(bitParallel); }, false, words, numbers, options);
+    }
+}
+
+// AddArc on an unfrozen NAutomaton, to compare with the builder
+template<unsigned int ALPHABET_SIZE>
+void BenchmarkAddArc(const Options &options) {
+    unsigned long long checksum = 0;
+    long long heapBytes = -1;
+    double seconds = Fastest(options, [&]() {
+        mt19937 random(options.seed);
+        long long before = HeapBytes();
+        NAutomaton<ALPHABET_SIZE> nfa;
+        for(unsigned int state = 0; state < options.states; state++) {
+            nfa.AddState(random() % 8 == 0);
+        }
+        for(unsigned int state = 0; state < options.states; state++) {
+            for(unsigned int label = 0; label < ALPHABET_SIZE; label++) {
+                for(unsigned int arc = 0; arc < options.arcsPerLabel; arc++) {
+                    nfa.AddArc(state, label, random() % options.states);
+                }
+            }
+        }
+        heapBytes = before < 0 ? -1 : HeapBytes() - before;
+        return static_cast<unsigned long long>(nfa.GetNumStates());
+    }, checksum);
+    PrintRow("construct_addarc", "nfa_random", options, static_cast<unsigned long long>(options.states) * ALPHABET_SIZE * options.arcsPerLabel, seconds, heapBytes, checksum);
+}
+
+template<unsigned int ALPHABET_SIZE>
+void RunAll(const Options &options) {
+    BenchmarkDFA<ALPHABET_SIZE>("dfa_random", RandomDFA<ALPHABET_SIZE>, options);
+    BenchmarkDFA<ALPHABET_SIZE>("dfa_scattered_cycle", ScatteredCycleDFA<ALPHABET_SIZE>, options);
+    BenchmarkAddArc<ALPHABET_SIZE>(options);
+    BenchmarkNFA<ALPHABET_SIZE>("nfa_random", RandomNFA<ALPHABET_SIZE>, options);
+    
+    // Shorter words never reach the final state
+    Options kthOptions = options;
+    kthOptions.length = max(options.length, options.states);
+    BenchmarkNFA<ALPHABET_SIZE>("nfa_kth_from_last", KthFromLastNFA<ALPHABET_SIZE>, kthOptions);
+}
+
+static void Usage(const char *program) {
+    cerr << "Usage: " << program << " [--alphabet 2|10|16|256] [--states N] [--arcs-per-label D]"
+         << " [--words W] [--length L] [--repeat R] [--seed S]" << endl;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for(int arg = 1; arg < argc; arg++) {
+        if(arg + 1 == argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++arg];
+        unsigned int number = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+        if(strcmp(argv[arg - 1], "--alphabet") == 0) {
+            options.alphabet = number;
+        } else if(strcmp(argv[arg - 1], "--states") == 0) {
+            options.states = number;
+        } else if(strcmp(argv[arg - 1], "--arcs-per-label") == 0) {
+            options.arcsPerLabel = number;
+        } else if(strcmp(argv[arg - 1], "--words") == 0) {
+            options.words = number;
+        } else if(strcmp(argv[arg - 1], "--length") == 0) {
+            options.length = number;
+        } else if(strcmp(argv[arg - 1], "--repeat") == 0) {
+            options.repeat = number;
+        } else if(strcmp(argv[arg - 1], "--seed") == 0) {
+            options.seed = number;
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    const bool supportedAlphabet = options.alphabet == 2 || options.alphabet == 10 || options.alphabet == 16 || options.alphabet == 256;
+    if(!supportedAlphabet || options.states == 0 || options.repeat == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+    
+    cout << "benchmark,instance,alphabet,states,operations,seconds,operations_per_second,heap_bytes,checksum\n";
+    switch(options.alphabet) {
+        case 2: RunAll<2>(options); break;
+        case 10: RunAll<10>(options); break;
+        case 16: RunAll<16>(options); break;
+        case 256: RunAll<256>(options); break;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,2 @@
+#!/bin/bash
+g++ -std=c++11 -O2 -DNDEBUG bench/Benchmark.cpp -I src/ -o benchmark
\ No newline at end of file
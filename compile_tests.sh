@@ -1,2 +1,2 @@
 #!/bin/bash
-g++ -std=c++11 test/TestMain.cpp test/TestDAutomaton.cpp test/TestNAutomaton.cpp test/TestDRegularLanguage.cpp test/TestNRegularLanguage.cpp -I src/
+g++ -std=c++11 test/TestMain.cpp test/TestDAutomaton.cpp test/TestNAutomaton.cpp test/TestDRegularLanguage.cpp test/TestNRegularLanguage.cpp test/TestDeterminize.cpp test/TestMinimize.cpp test/TestNAutomatonBuilder.cpp test/TestDStrideLanguage.cpp test/TestStateIdWidth.cpp test/TestProduct.cpp test/TestEquivalence.cpp test/TestSerialization.cpp test/TestMappedDAutomaton.cpp test/TestCounting.cpp test/TestEnumerate.cpp test/TestDigitIterator.cpp test/TestRemoveEpsilons.cpp test/TestRegex.cpp test/TestInstrumentation.cpp test/TestMatcher.cpp test/TestParallelDeterminize.cpp test/TestParallelMinimize.cpp test/TestDAutomatonBuilder.cpp test/TestTrim.cpp test/TestCompressedDAutomaton.cpp test/TestCompiledMatcher.cpp test/TestScanner.cpp -I src/ -pthread
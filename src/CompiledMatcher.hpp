@@ -0,0 +1,105 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "utils/DigitIterator.hpp"
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // A read-only snapshot of a DAutomaton and initial state for membership queries.
+    // Everything is checked once at construction: missing arcs and the initial state,
+    // if invalid, are redirected to a sink state that loops on every label, and each
+    // row gets one extra column, also leading to the sink, for labels outside the
+    // alphabet. Table entries hold the offset of their destination's row, so a step is
+    // an add, a clamp of the label and a load, with no branch. contains is const and
+    // touches no mutable state, one matcher can serve any number of threads.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    class CompiledMatcher {
+        public:
+            typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+            
+            typedef typename Machine::Label Character;
+            typedef typename Machine::StateId StateId;
+            
+            // Offset of a row in the table, at least 32 bits wide
+            typedef typename std::common_type<StateId, unsigned int>::type Offset;
+            
+            constexpr static std::size_t ROW_SIZE = static_cast<std::size_t>(ALPHABET_SIZE) + 1;
+            
+            // Dfa is a DAutomaton or a read-only automaton with the same queries, like MappedDAutomaton
+            template<class Dfa>
+            CompiledMatcher(const Dfa &dfa, StateId initialState) {
+                const std::size_t numStates = dfa.GetNumStates();
+                const std::size_t sink = numStates;
+                if(sink + 1 > std::numeric_limits<Offset>::max() / ROW_SIZE) {
+                    throw std::out_of_range("Too many states");
+                }
+                
+                mTable.resize((sink + 1) * ROW_SIZE);
+                mFinalStates.resize(sink + 1);
+                for(std::size_t state = 0; state <= sink; state++) {
+                    Offset *row = &mTable[state * ROW_SIZE];
+                    for(Character label = 0; label < ALPHABET_SIZE; label++) {
+                        StateId next = state == sink ? Dfa::INVALID_STATE : dfa.GetNext(state, label);
+                        row[label] = static_cast<Offset>((next == Dfa::INVALID_STATE ? sink : next) * ROW_SIZE);
+                    }
+                    row[ALPHABET_SIZE] = static_cast<Offset>(sink * ROW_SIZE);
+                    mFinalStates[state] = state != sink && dfa.IsFinal(state);
+                }
+                mInitialOffset = static_cast<Offset>((dfa.IsValidState(initialState) ? initialState : sink) * ROW_SIZE);
+            }
+            
+            template<class Instrumentation, class Automaton>
+            explicit CompiledMatcher(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation, Automaton> &language) :
+                CompiledMatcher(*language.GetAutomaton(), language.GetInitialState())
+            {}
+            
+            CompiledMatcher(CompiledMatcher&& other) = default;
+            
+            // noexcept as long as reading and advancing the iterators cannot throw
+            template<typename IterType>
+            bool contains(IterType begin, IterType end) const noexcept(noexcept(*begin) && noexcept(++begin) && noexcept(begin != end)) {
+                const Offset *table = mTable.data();
+                Offset offset = mInitialOffset;
+                for(auto iter = begin; iter != end; ++iter) {
+                    Character c = *iter;
+                    offset = table[offset + std::min<Character>(c, ALPHABET_SIZE)];
+                }
+                return mFinalStates[offset / ROW_SIZE];
+            }
+            
+            bool contains(unsigned int number) const noexcept {
+                return contains(DigitIterator<ALPHABET_SIZE, Character>(number), DigitIterator<ALPHABET_SIZE, Character>::end());
+            }
+            
+            // Any unsigned builtin, unsigned __int128 or cpp_int, its digits read in the given order
+            template<DigitOrder ORDER = DigitOrder::LeastSignificantFirst, typename NumberType>
+            bool containsNumber(const NumberType &number) const {
+                typedef typename DigitIteratorFor<ALPHABET_SIZE, ORDER, Character, NumberType>::type Digits;
+                return contains(Digits(number), Digits::end());
+            }
+            
+            // Includes the sink
+            std::size_t GetNumStates() const {
+                return mFinalStates.size();
+            }
+        
+        private:
+            // Indexed by state * ROW_SIZE + label, the last column is for labels outside the alphabet
+            std::vector<Offset> mTable;
+            boost::dynamic_bitset<> mFinalStates;
+            Offset mInitialOffset;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    constexpr std::size_t CompiledMatcher<ALPHABET_SIZE, StateIdType>::ROW_SIZE;
+}
\ No newline at end of file
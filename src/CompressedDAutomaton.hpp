@@ -0,0 +1,204 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "utils/DigitIterator.hpp"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace FACore {
+    
+    // A read-only DAutomaton whose labels are grouped into equivalence classes. Two labels
+    // share a class when every state sends them to the same destination, so each state only
+    // stores one destination per class and a single ALPHABET_SIZE entry map turns labels
+    // into classes. For byte inputs most automata tell apart a handful of classes, which
+    // shrinks each row from 256 entries to that handful. Labels keep their meaning,
+    // GetNext takes a Label as with DAutomaton.
+    template<unsigned int AlphabetSize, typename StateIdType = unsigned int>
+    class CompressedDAutomaton {
+        public:
+            typedef DAutomaton<AlphabetSize, StateIdType> Machine;
+            
+            typedef typename Machine::StateId StateId;
+            typedef typename Machine::Label Label;
+            
+            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
+            constexpr static StateId INVALID_STATE = Machine::INVALID_STATE;
+            
+            // Wide enough for ALPHABET_SIZE classes
+            typedef typename std::conditional<(AlphabetSize <= 0x100u), std::uint8_t,
+                    typename std::conditional<(AlphabetSize <= 0x10000u), std::uint16_t,
+                    std::uint32_t>::type>::type ClassId;
+            
+            typedef std::array<ClassId, ALPHABET_SIZE> ClassMap;
+            
+            // Classes are found by refining the partition of the labels with one state at a
+            // time, O(n * ALPHABET_SIZE) expected. They are numbered in order of their smallest label.
+            explicit CompressedDAutomaton(const Machine &dfa) : mNumStates(dfa.GetNumStates()), mFinalStates(dfa.GetNumStates())
+            {
+                mClassOf.fill(0);
+                std::size_t numClasses = 1;
+                std::unordered_map<std::pair<ClassId, StateId>, ClassId, boost::hash<std::pair<ClassId, StateId> > > refined;
+                for(StateId state = 0; state < mNumStates && numClasses < ALPHABET_SIZE; state++) {
+                    refined.clear();
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        auto inserted = refined.emplace(std::make_pair(mClassOf[label], dfa.GetNext(state, label)), static_cast<ClassId>(refined.size()));
+                        mClassOf[label] = inserted.first->second;
+                    }
+                    numClasses = refined.size();
+                }
+                mNumClasses = numClasses;
+                
+                // Any label of a class stands for the whole class
+                std::vector<Label> representatives(mNumClasses, ALPHABET_SIZE);
+                for(Label label = ALPHABET_SIZE; label-- > 0;) {
+                    representatives[mClassOf[label]] = label;
+                }
+                
+                mTransitions.resize(static_cast<std::size_t>(mNumStates) * mNumClasses);
+                for(StateId state = 0; state < mNumStates; state++) {
+                    for(std::size_t c = 0; c < mNumClasses; c++) {
+                        mTransitions[static_cast<std::size_t>(state) * mNumClasses + c] = dfa.GetNext(state, representatives[c]);
+                    }
+                    mFinalStates[state] = dfa.IsFinal(state);
+                }
+            }
+            
+            CompressedDAutomaton(CompressedDAutomaton&& other) = default;
+            
+            bool IsValidState(StateId state) const {
+                return state < mNumStates;
+            }
+            
+            bool IsValidLabel(Label label) const {
+                return label < ALPHABET_SIZE;
+            }
+            
+            StateId GetNumStates() const {
+                return mNumStates;
+            }
+            
+            std::size_t GetNumClasses() const {
+                return mNumClasses;
+            }
+            
+            ClassId GetClass(Label label) const {
+                return mClassOf[label];
+            }
+            
+            StateId GetNext(StateId src, Label label) const {
+                if(IsValidState(src) && IsValidLabel(label)) {
+                    return mTransitions[static_cast<std::size_t>(src) * mNumClasses + mClassOf[label]];
+                } else {
+                    return INVALID_STATE;
+                }
+            }
+            
+            // Indexed by Label. No bounds checking, intended for hot loops together with GetTransitionTable.
+            const ClassMap& GetClassMap() const {
+                return mClassOf;
+            }
+            
+            // Indexed by state * GetNumClasses() + class. No bounds checking, intended for hot loops.
+            const StateId* GetTransitionTable() const {
+                return mTransitions.data();
+            }
+            
+            bool IsFinal(StateId state) const {
+                if(!IsValidState(state)) {
+                    return false;
+                }
+                return mFinalStates[state];
+            }
+            
+            // Memory taken by the class map and the transitions
+            std::size_t GetTableSize() const {
+                return sizeof(ClassMap) + mTransitions.size() * sizeof(StateId);
+            }
+        
+        private:
+            StateId mNumStates;
+            std::size_t mNumClasses;
+            ClassMap mClassOf;
+            std::vector<StateId> mTransitions;
+            boost::dynamic_bitset<> mFinalStates;
+    };
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr unsigned int CompressedDAutomaton<AlphabetSize, StateIdType>::ALPHABET_SIZE;
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr typename CompressedDAutomaton<AlphabetSize, StateIdType>::StateId CompressedDAutomaton<AlphabetSize, StateIdType>::INVALID_STATE;
+    
+    // The DRegularLanguage counterpart over a CompressedDAutomaton. Each character costs
+    // a class map lookup and a row lookup, both from tables that usually fit in L1.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    class DCompressedLanguage {
+        public:
+            typedef CompressedDAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+            
+            typedef typename Machine::Label Character;
+            typedef typename Machine::StateId StateId;
+            
+            DCompressedLanguage(std::shared_ptr<const Machine> automaton, StateId initialState) : mAutomaton(automaton), mInitialState(initialState)
+            {}
+            
+            DCompressedLanguage(const DAutomaton<ALPHABET_SIZE, StateIdType> &dfa, StateId initialState) : DCompressedLanguage(std::make_shared<const Machine>(dfa), initialState)
+            {}
+            
+            DCompressedLanguage(DCompressedLanguage&& other) = default;
+            
+            template<typename IterType>
+            bool contains(IterType begin, IterType end) const {
+                const typename Machine::ClassMap &classOf = mAutomaton->GetClassMap();
+                const StateId *table = mAutomaton->GetTransitionTable();
+                const std::size_t numClasses = mAutomaton->GetNumClasses();
+                
+                StateId currentState = mInitialState;
+                if(!mAutomaton->IsValidState(currentState)) {
+                    return false;
+                }
+                for(auto iter = begin; iter != end; ++iter) {
+                    Character c = *iter;
+                    if(!mAutomaton->IsValidLabel(c)) {
+                        return false;
+                    }
+                    currentState = table[static_cast<std::size_t>(currentState) * numClasses + classOf[c]];
+                    if(currentState == Machine::INVALID_STATE) {
+                        return false;
+                    }
+                }
+                return mAutomaton->IsFinal(currentState);
+            }
+            
+            bool contains(unsigned int number) const {
+                return contains(DigitIterator<ALPHABET_SIZE, Character>(number), DigitIterator<ALPHABET_SIZE, Character>::end());
+            }
+            
+            // Any unsigned builtin, unsigned __int128 or cpp_int, its digits read in the given order
+            template<DigitOrder ORDER = DigitOrder::LeastSignificantFirst, typename NumberType>
+            bool containsNumber(const NumberType &number) const {
+                typedef typename DigitIteratorFor<ALPHABET_SIZE, ORDER, Character, NumberType>::type Digits;
+                return contains(Digits(number), Digits::end());
+            }
+            
+            std::shared_ptr<const Machine> GetAutomaton() const {
+                return mAutomaton;
+            }
+            
+            StateId GetInitialState() const {
+                return mInitialState;
+            }
+        
+        private:
+            std::shared_ptr<const Machine> mAutomaton;
+            StateId mInitialState;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "utils/DigitIterator.hpp"
+
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace FACore {
+    
+    // Exact, unbounded count of accepted numbers
+    typedef boost::multiprecision::cpp_int AcceptedCount;
+    
+    // The digits DigitIterator produces for number, least significant first, without
+    // leading zeros. NumberType may be any unsigned builtin, unsigned __int128 or cpp_int.
+    template<unsigned int ALPHABET_SIZE, typename NumberType>
+    std::vector<unsigned int> LeastSignificantDigits(NumberType number) {
+        typedef DigitArithmetic<ALPHABET_SIZE, NumberType> Arithmetic;
+        
+        std::vector<unsigned int> digits;
+        for(; number != 0; Arithmetic::DropLowDigit(number)) {
+            digits.push_back(Arithmetic::LowDigit(number));
+        }
+        return digits;
+    }
+    
+    // Number of n in [0, high] whose digits, read least significant first, are accepted
+    // from initialState. With L the number of digits of high this runs in O(L*n*k):
+    //  - reachable[i][s] counts the words of length i leading to state s,
+    //  - accepts[i][s] tells whether reading the digits of high above position i from s
+    //    ends in a final state.
+    // A number below high with L digits agrees with high above some position i and has
+    // a smaller digit at i, its lower digits are free; shorter numbers are any words whose
+    // last digit is non zero.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, typename NumberType>
+    AcceptedCount CountAcceptedUpTo(const DAutomaton<ALPHABET_SIZE, StateIdType> &automaton, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState, NumberType high) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        if(!automaton.IsValidState(initialState)) {
+            return 0;
+        }
+        
+        const std::vector<unsigned int> digits = LeastSignificantDigits<ALPHABET_SIZE>(high);
+        const std::size_t length = digits.size();
+        const StateId numStates = automaton.GetNumStates();
+        
+        // Zero is the empty word
+        AcceptedCount result = automaton.IsFinal(initialState) ? 1 : 0;
+        if(length == 0) {
+            return result;
+        }
+        
+        std::vector<boost::dynamic_bitset<> > accepts(length, boost::dynamic_bitset<>(numStates));
+        for(StateId state = 0; state < numStates; state++) {
+            accepts[length - 1][state] = automaton.IsFinal(state);
+        }
+        for(std::size_t position = length - 1; position-- > 0; ) {
+            for(StateId state = 0; state < numStates; state++) {
+                StateId next = automaton.GetNext(state, digits[position + 1]);
+                accepts[position][state] = next != Machine::INVALID_STATE && accepts[position + 1][next];
+            }
+        }
+        
+        std::vector<AcceptedCount> reachable(numStates);
+        std::vector<AcceptedCount> nextReachable(numStates);
+        reachable[initialState] = 1;
+        
+        for(std::size_t position = 0; position < length; position++) {
+            const bool topDigit = position + 1 == length;
+            for(StateId state = 0; state < numStates; state++) {
+                if(reachable[state].is_zero()) {
+                    continue;
+                }
+                for(Label digit = 1; digit < ALPHABET_SIZE; digit++) {
+                    StateId next = automaton.GetNext(state, digit);
+                    if(next == Machine::INVALID_STATE) {
+                        continue;
+                    }
+                    // Numbers with position + 1 digits that are shorter than high
+                    if(!topDigit && automaton.IsFinal(next)) {
+                        result += reachable[state];
+                    }
+                    // Numbers with as many digits as high, the first difference is here
+                    if(digit < digits[position] && accepts[position][next]) {
+                        result += reachable[state];
+                    }
+                }
+                // A zero can only be the first difference below the top digit
+                StateId next = automaton.GetNext(state, 0);
+                if(!topDigit && digits[position] > 0 && next != Machine::INVALID_STATE && accepts[position][next]) {
+                    result += reachable[state];
+                }
+            }
+            
+            if(topDigit) {
+                break;
+            }
+            for(AcceptedCount &count : nextReachable) {
+                count = 0;
+            }
+            for(StateId state = 0; state < numStates; state++) {
+                if(reachable[state].is_zero()) {
+                    continue;
+                }
+                for(Label digit = 0; digit < ALPHABET_SIZE; digit++) {
+                    StateId next = automaton.GetNext(state, digit);
+                    if(next != Machine::INVALID_STATE) {
+                        nextReachable[next] += reachable[state];
+                    }
+                }
+            }
+            reachable.swap(nextReachable);
+        }
+        
+        // high itself
+        StateId state = initialState;
+        for(std::size_t position = 0; position < length && state != Machine::INVALID_STATE; position++) {
+            state = automaton.GetNext(state, digits[position]);
+        }
+        if(automaton.IsFinal(state)) {
+            result += 1;
+        }
+        return result;
+    }
+    
+    // Number of n in [low, high] that are accepted, zero if low > high
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, typename NumberType>
+    AcceptedCount CountAccepted(const DAutomaton<ALPHABET_SIZE, StateIdType> &automaton, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState, NumberType low, NumberType high) {
+        if(high < low) {
+            return 0;
+        }
+        AcceptedCount result = CountAcceptedUpTo(automaton, initialState, high);
+        if(low != 0) {
+            result -= CountAcceptedUpTo(automaton, initialState, NumberType(low - 1));
+        }
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation, typename NumberType>
+    AcceptedCount CountAcceptedUpTo(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language, NumberType high) {
+        return CountAcceptedUpTo(*language.GetAutomaton(), language.GetInitialState(), high);
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation, typename NumberType>
+    AcceptedCount CountAccepted(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language, NumberType low, NumberType high) {
+        return CountAccepted(*language.GetAutomaton(), language.GetInitialState(), low, high);
+    }
+}
\ No newline at end of file
@@ -1,22 +1,30 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 #include <stdexcept>
 #include <climits>
 #include <array>
 #include <limits>
+#include <type_traits>
 #include <boost/dynamic_bitset.hpp>
 
 namespace FACore {
+    template<unsigned int AlphabetSize, typename StateIdType>
+    class DAutomatonBuilder;
     
-    template<unsigned int AlphabetSize>
+    // StateIdType must be an unsigned integer type, its maximum value is reserved for INVALID_STATE.
+    // Narrower types shrink every TransitionArr, see StateIdWidth.hpp for choosing one.
+    template<unsigned int AlphabetSize, typename StateIdType = unsigned int>
     class DAutomaton {
         public:
-            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
-            constexpr static unsigned int INVALID_STATE = std::numeric_limits<unsigned int>::max();
+            static_assert(std::is_integral<StateIdType>::value && std::is_unsigned<StateIdType>::value, "StateIdType must be an unsigned integer type");
             
             // A StateId is really just an index into a vector
-            typedef unsigned int StateId;
+            typedef StateIdType StateId;
+            
+            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
+            constexpr static StateId INVALID_STATE = std::numeric_limits<StateId>::max();
             
             // Label values must be between 0 and ALPHABET_SIZE
             typedef unsigned int Label;
@@ -24,15 +32,39 @@ namespace FACore {
             // These arrays will be indexed by Label
             typedef std::array<StateId, ALPHABET_SIZE> TransitionArr;
             
+            DAutomaton() = default;
+            
+            // Takes over a complete transition table, one row and one final bit per state.
+            // Every destination is validated once, instead of on each SetArc.
+            DAutomaton(std::vector<TransitionArr> &&transitions, boost::dynamic_bitset<> &&finalStates)
+            {
+                if(transitions.size() != finalStates.size()) {
+                    throw std::out_of_range("Transition table and final states differ in size");
+                }
+                if(transitions.size() > INVALID_STATE) {
+                    throw std::out_of_range("Too many states");
+                }
+                for(const TransitionArr &row : transitions) {
+                    for(StateId dest : row) {
+                        if(dest >= transitions.size() && dest != INVALID_STATE) {
+                            throw std::out_of_range("Invalid dest state");
+                        }
+                    }
+                }
+                mTransitions.swap(transitions);
+                mFinalStates.swap(finalStates);
+            }
+            
             StateId AddState(bool isFinal) {
-                if(mFinalStates.size() == INVALID_STATE) {
+                if(mFinalStates.size() >= INVALID_STATE) {
                     // WARNING this is outside of testing code coverage
                     throw std::out_of_range("Invalid label"); 
                 }
                 StateId result = mTransitions.size();
                 mTransitions.emplace_back();
-                mTransitions[result].fill((unsigned int)INVALID_STATE);
+                mTransitions[result].fill(INVALID_STATE);
                 mFinalStates.push_back(isFinal);
+                mGeneration++;
                 return result;
             }
             
@@ -47,6 +79,7 @@ namespace FACore {
                     throw std::out_of_range("Invalid dest state");
                 }
                 mTransitions[src][label] = dest;
+                mGeneration++;
             }
             
             bool IsValidState(StateId state) const {
@@ -57,6 +90,10 @@ namespace FACore {
                 return label < ALPHABET_SIZE;
             }
             
+            StateId GetNumStates() const {
+                return mTransitions.size();
+            }
+            
             StateId GetNext(StateId src, Label label) const {
                 if(IsValidState(src) && IsValidLabel(label) ) {
                     return mTransitions[src][label];
@@ -65,17 +102,37 @@ namespace FACore {
                 }
             }
             
+            // Rows are indexed by StateId, entries by Label. No bounds checking, intended for hot loops.
+            const TransitionArr* GetTransitionTable() const {
+                return mTransitions.data();
+            }
+            
             bool IsFinal(StateId state) const {
                 if(!IsValidState(state)) {
                     return false;
                 }
                 return mFinalStates[state];
             }
+            
+            // Changes whenever a state or arc is added, so that anything derived from the automaton can tell it is stale
+            std::size_t GetGeneration() const {
+                return mGeneration;
+            }
         
         private:
+            friend class DAutomatonBuilder<AlphabetSize, StateIdType>;
+            
             std::vector<TransitionArr> mTransitions;
             boost::dynamic_bitset<> mFinalStates;
+            std::size_t mGeneration = 0;
     };
     
+    // Out of class definitions, needed when these are bound to a reference
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr unsigned int DAutomaton<AlphabetSize, StateIdType>::ALPHABET_SIZE;
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr typename DAutomaton<AlphabetSize, StateIdType>::StateId DAutomaton<AlphabetSize, StateIdType>::INVALID_STATE;
+    
     typedef DAutomaton<2> DFA;
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // Builds a DAutomaton in bulk. Capacity is reserved once, states are added in runs
+    // and arcs in batches of (src,label,dest) triples that are validated with a single
+    // pass before any of them is applied. Freeze moves the table into the automaton,
+    // so nothing is copied and DAutomaton's own per-destination validation is skipped.
+    template<unsigned int AlphabetSize, typename StateIdType = unsigned int>
+    class DAutomatonBuilder {
+        public:
+            typedef DAutomaton<AlphabetSize, StateIdType> Machine;
+            
+            typedef typename Machine::StateId StateId;
+            typedef typename Machine::Label Label;
+            typedef typename Machine::TransitionArr TransitionArr;
+            
+            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
+            
+            struct Arc {
+                StateId src;
+                Label label;
+                StateId dest;
+            };
+            
+            void Reserve(StateId numStates) {
+                mTransitions.reserve(numStates);
+                mFinalStates.reserve(numStates);
+            }
+            
+            StateId AddState(bool isFinal) {
+                return AddStates(1, isFinal);
+            }
+            
+            // Adds count states without arcs and returns the first one, the rest follow it
+            StateId AddStates(StateId count, bool isFinal) {
+                if(count > Machine::INVALID_STATE - mTransitions.size()) {
+                    // WARNING this is outside of testing code coverage
+                    throw std::out_of_range("Too many states");
+                }
+                StateId result = mTransitions.size();
+                TransitionArr empty;
+                empty.fill(Machine::INVALID_STATE);
+                mTransitions.resize(mTransitions.size() + count, empty);
+                mFinalStates.resize(mFinalStates.size() + count, isFinal);
+                return result;
+            }
+            
+            void SetFinal(StateId state, bool isFinal) {
+                if(mTransitions.size() <= state) {
+                    throw std::out_of_range("Invalid state");
+                }
+                mFinalStates[state] = isFinal;
+            }
+            
+            void SetArc(StateId src, Label label, StateId dest) {
+                Validate(1, src, label, dest);
+                mTransitions[src][label] = dest;
+            }
+            
+            // Applies all arcs or none of them, later arcs overwrite earlier ones as with SetArc
+            void SetArcs(const Arc *arcs, std::size_t count) {
+                StateId maxSrc = 0;
+                StateId maxDest = 0;
+                Label maxLabel = 0;
+                for(std::size_t i = 0; i < count; i++) {
+                    maxSrc = std::max(maxSrc, arcs[i].src);
+                    maxDest = std::max(maxDest, arcs[i].dest);
+                    maxLabel = std::max(maxLabel, arcs[i].label);
+                }
+                Validate(count, maxSrc, maxLabel, maxDest);
+                for(std::size_t i = 0; i < count; i++) {
+                    mTransitions[arcs[i].src][arcs[i].label] = arcs[i].dest;
+                }
+            }
+            
+            void SetArcs(const std::vector<Arc> &arcs) {
+                SetArcs(arcs.data(), arcs.size());
+            }
+            
+            StateId GetNumStates() const {
+                return mTransitions.size();
+            }
+            
+            // Hands the collected table to a new DAutomaton and resets the builder
+            Machine Freeze() {
+                Machine machine;
+                machine.mTransitions.swap(mTransitions);
+                machine.mFinalStates.swap(mFinalStates);
+                
+                mTransitions.clear();
+                mFinalStates.clear();
+                return machine;
+            }
+        
+        private:
+            void Validate(std::size_t count, StateId maxSrc, Label maxLabel, StateId maxDest) const {
+                if(count == 0) {
+                    return;
+                }
+                if(ALPHABET_SIZE <= maxLabel) {
+                    throw std::out_of_range("Invalid label");
+                }
+                if(mTransitions.size() <= maxSrc) {
+                    throw std::out_of_range("Invalid source state.");
+                }
+                if(mTransitions.size() <= maxDest) {
+                    throw std::out_of_range("Invalid dest state");
+                }
+            }
+            
+            std::vector<TransitionArr> mTransitions;
+            boost::dynamic_bitset<> mFinalStates;
+    };
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr unsigned int DAutomatonBuilder<AlphabetSize, StateIdType>::ALPHABET_SIZE;
+    
+    typedef DAutomatonBuilder<2> DFABuilder;
+}
\ No newline at end of file
@@ -1,27 +1,49 @@
 #pragma once
 
 #include "utils/DigitIterator.hpp"
+#include "utils/Instrumentation.hpp"
+#include "utils/DecidedStates.hpp"
+#include "utils/Scanner.hpp"
 #include "DAutomaton.hpp"
 
 #include <memory>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include <boost/dynamic_bitset.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace FACore {
-    template<unsigned int ALPHABET_SIZE>
-    class DRegularLanguage {
+    // Instrumentation is a policy from utils/Instrumentation.hpp, the default records nothing.
+    // Automaton is a DAutomaton or a read-only automaton with the same queries, like
+    // MappedDAutomaton. The operations that build new languages only take DAutomaton.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int, class Instrumentation = NoInstrumentation, class Automaton = DAutomaton<ALPHABET_SIZE, StateIdType> >
+    class DRegularLanguage : private Instrumentation {
         
         public:
-            typedef DAutomaton<ALPHABET_SIZE> Machine;
+            typedef Automaton Machine;
+            
+            static_assert(Machine::ALPHABET_SIZE == ALPHABET_SIZE && std::is_same<typename Machine::StateId, StateIdType>::value, "Automaton must have the alphabet and StateId of the language");
             
             typedef typename Machine::Label Character;
             typedef typename Machine::StateId StateId;
             
             constexpr static unsigned int AlphabetSize = ALPHABET_SIZE;
+            
+            // Number of inputs containsBatch advances in lockstep
+            constexpr static std::size_t BATCH_LANES = 16;
         
         private:
             typedef DigitIterator<ALPHABET_SIZE, Character> Digitizer;
         
         public:
-            DRegularLanguage(std::shared_ptr<const Machine> automaton, StateId initialState) : mAutomaton(automaton), mInitialState(initialState)
+            // Dead and accepting states are only found by the first query, so languages that are
+            // never queried cost nothing, and found again once the automaton has changed.
+            DRegularLanguage(std::shared_ptr<const Machine> automaton, StateId initialState) : mAutomaton(automaton), mInitialState(initialState), mHasDecidedStates(false), mDecidedGeneration(NOT_ANALYZED), mScannerGeneration(NOT_ANALYZED)
             {}
             
             DRegularLanguage(Machine* automaton, StateId initialState) : DRegularLanguage(std::shared_ptr<const Machine>(automaton), initialState)
@@ -30,22 +52,221 @@ namespace FACore {
             // These objects are lightweight and dynamic allocating should be avoided.
             DRegularLanguage(DRegularLanguage&& other) = default;
             
+            virtual ~DRegularLanguage() = default;
+            
             template<typename IterType>
             bool contains(IterType begin, IterType end) {
+                UpdateDecidedStates();
                 StateId currentState = mInitialState;
-                for(auto iter = begin; iter != end && currentState != Machine::INVALID_STATE; ++iter) {
-                    Character c = *iter;
-                    currentState = mAutomaton->GetNext(currentState, c);
+                std::size_t consumed = 0;
+                auto iter = begin;
+                if(mHasDecidedStates) {
+                    for(; iter != end && IsUndecided(currentState); ++iter, ++consumed) {
+                        Character c = *iter;
+                        currentState = mAutomaton->GetNext(currentState, c);
+                    }
+                } else {
+                    // Only INVALID_STATE can end the walk early, checking the flags would be wasted
+                    for(; iter != end && currentState != Machine::INVALID_STATE; ++iter, ++consumed) {
+                        Character c = *iter;
+                        currentState = mAutomaton->GetNext(currentState, c);
+                    }
+                }
+                if(Instrumentation::ENABLED) {
+                    Instrumentation::RecordQuery(consumed, iter != end);
                 }
-                return mAutomaton->IsFinal(currentState);
+                // Dead states are never final and accepting states always are, as long as the rest is valid
+                return mAutomaton->IsFinal(currentState) && AllLabelsValid<ALPHABET_SIZE>(iter, end);
             }
             
             virtual bool contains(unsigned int number) {
                 return contains(Digitizer(number), Digitizer::end());
             }
+            
+            // Any unsigned builtin, unsigned __int128 or cpp_int, its digits read in the given order
+            template<DigitOrder ORDER = DigitOrder::LeastSignificantFirst, typename NumberType>
+            bool containsNumber(const NumberType &number) {
+                typedef typename DigitIteratorFor<ALPHABET_SIZE, ORDER, Character, NumberType>::type Digits;
+                return contains(Digits(number), Digits::end());
+            }
+            
+            // Sets out[i] to contains(numbers[i]) for each of the count numbers
+            void containsBatch(const unsigned int *numbers, std::size_t count, boost::dynamic_bitset<> &out) {
+                containsBatch(numbers, numbers + count, out);
+            }
+            
+            // Replaces the contents of out with one membership bit per number in [begin, end).
+            // BATCH_LANES numbers are walked through the automaton in lockstep, so their
+            // transition loads are independent and can overlap instead of forming a single
+            // dependent chain. With AVX2 and a power of two alphabet, the steps are done with gathers.
+            // With an enabled Instrumentation each number goes through contains instead, so that it is counted.
+            template<typename IterType>
+            void containsBatch(IterType begin, IterType end, boost::dynamic_bitset<> &out) {
+                out.clear();
+                if(Instrumentation::ENABLED) {
+                    for(auto iter = begin; iter != end; ++iter) {
+                        out.push_back(contains(static_cast<unsigned int>(*iter)));
+                    }
+                    return;
+                }
+                if(!mAutomaton->IsValidState(mInitialState)) {
+                    for(auto iter = begin; iter != end; ++iter) {
+                        out.push_back(false);
+                    }
+                    return;
+                }
+                
+                unsigned int values[BATCH_LANES];
+                StateId states[BATCH_LANES];
+                auto iter = begin;
+                while(iter != end) {
+                    std::size_t lanes = 0;
+                    for(; lanes < BATCH_LANES && iter != end; ++iter, ++lanes) {
+                        values[lanes] = *iter;
+                        states[lanes] = mInitialState;
+                    }
+                    
+                    RunLanes(values, states, lanes);
+                    
+                    for(std::size_t lane = 0; lane < lanes; lane++) {
+                        out.push_back(mAutomaton->IsFinal(states[lane]));
+                    }
+                }
+            }
+            
+            // Calls callback(offset) for every offset in [0, end - begin] at which some substring
+            // of the input in the language ends, in one pass. The scanner is built on first use.
+            template<typename IterType, class Callback>
+            void scan(IterType begin, IterType end, Callback callback) {
+                if(!mScanner || mScannerGeneration != mAutomaton->GetGeneration()) {
+                    mScanner.reset(new Scanner<ALPHABET_SIZE, StateIdType>(*mAutomaton, mInitialState));
+                    mScannerGeneration = mAutomaton->GetGeneration();
+                }
+                mScanner->scan(begin, end, callback);
+            }
+            
+            std::shared_ptr<const Machine> GetAutomaton() const {
+                return mAutomaton;
+            }
+            
+            StateId GetInitialState() const {
+                return mInitialState;
+            }
+            
+            const Instrumentation& GetInstrumentation() const {
+                return *this;
+            }
+            
+            Instrumentation& GetInstrumentation() {
+                return *this;
+            }
         
         private:
+            typedef typename Machine::TransitionArr TransitionArr;
+            
+            constexpr static std::size_t NOT_ANALYZED = std::numeric_limits<std::size_t>::max();
+            
+            void UpdateDecidedStates() {
+                if(mDecidedGeneration == mAutomaton->GetGeneration()) {
+                    return;
+                }
+                DecidedStates decided = FindDecidedStates(*mAutomaton);
+                mUndecided = ~(decided.dead | decided.accepting);
+                mHasDecidedStates = !mUndecided.all();
+                mDecidedGeneration = mAutomaton->GetGeneration();
+            }
+            
+            // INVALID_STATE and other states outside the automaton count as decided, they are dead
+            bool IsUndecided(StateId state) const {
+                return state < mUndecided.size() && mUndecided[state];
+            }
+            
+            // Consumes every digit of each value, states must start out valid
+            void RunLanes(unsigned int *values, StateId *states, std::size_t lanes) const {
+                const TransitionArr *table = mAutomaton->GetTransitionTable();
+
+#if defined(__AVX2__)
+                if(lanes == BATCH_LANES && CanGather()) {
+                    RunLanesGather(values, states, table);
+                    return;
+                }
+#endif
+                
+                bool active = true;
+                while(active) {
+                    active = false;
+                    for(std::size_t lane = 0; lane < lanes; lane++) {
+                        if(values[lane] != 0 && states[lane] != Machine::INVALID_STATE) {
+                            states[lane] = table[states[lane]][values[lane] % ALPHABET_SIZE];
+                            values[lane] /= ALPHABET_SIZE;
+                            active = true;
+                        }
+                    }
+                }
+            }
+
+#if defined(__AVX2__)
+            // Gather indices are signed 32 bit offsets into the table
+            bool CanGather() const {
+                return (ALPHABET_SIZE & (ALPHABET_SIZE - 1)) == 0 &&
+                       sizeof(StateId) == sizeof(int) &&
+                       sizeof(TransitionArr) == ALPHABET_SIZE * sizeof(StateId) &&
+                       static_cast<unsigned long long>(mAutomaton->GetNumStates()) * ALPHABET_SIZE <= static_cast<unsigned long long>(std::numeric_limits<int>::max());
+            }
+            
+            // Two independent vectors of 8 lanes, so that one gather can issue while the other waits
+            static void RunLanesGather(unsigned int *values, StateId *states, const TransitionArr *table) {
+                const int shift = __builtin_ctz(ALPHABET_SIZE);
+                const __m256i digitMask = _mm256_set1_epi32(ALPHABET_SIZE - 1);
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i invalid = _mm256_set1_epi32(static_cast<int>(Machine::INVALID_STATE));
+                const int *base = reinterpret_cast<const int*>(table);
+                
+                __m256i value[2], state[2], active[2];
+                for(int half = 0; half < 2; half++) {
+                    value[half] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 8 * half));
+                    state[half] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + 8 * half));
+                }
+                while(true) {
+                    int running = 0;
+                    for(int half = 0; half < 2; half++) {
+                        __m256i finished = _mm256_or_si256(_mm256_cmpeq_epi32(value[half], zero), _mm256_cmpeq_epi32(state[half], invalid));
+                        active[half] = _mm256_andnot_si256(finished, _mm256_set1_epi32(-1));
+                        running |= _mm256_movemask_epi8(active[half]);
+                    }
+                    if(running == 0) {
+                        break;
+                    }
+                    for(int half = 0; half < 2; half++) {
+                        __m256i index = _mm256_add_epi32(_mm256_slli_epi32(state[half], shift), _mm256_and_si256(value[half], digitMask));
+                        state[half] = _mm256_mask_i32gather_epi32(state[half], base, index, active[half], sizeof(StateId));
+                        value[half] = _mm256_srli_epi32(value[half], shift);
+                    }
+                }
+                for(int half = 0; half < 2; half++) {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + 8 * half), state[half]);
+                }
+            }
+#endif
+            
             std::shared_ptr<const Machine> mAutomaton;
             StateId mInitialState;
+            
+            // States that are neither dead nor accepting, contains stops at any other state
+            boost::dynamic_bitset<> mUndecided;
+            bool mHasDecidedStates;
+            
+            // Generation of the automaton that mUndecided was computed for
+            std::size_t mDecidedGeneration;
+            
+            // Only populated once scan is called, rebuilt once the automaton has changed
+            std::unique_ptr<Scanner<ALPHABET_SIZE, StateIdType> > mScanner;
+            std::size_t mScannerGeneration;
     };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation, class Automaton>
+    constexpr std::size_t DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation, Automaton>::BATCH_LANES;
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation, class Automaton>
+    constexpr std::size_t DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation, Automaton>::NOT_ANALYZED;
 }
\ No newline at end of file
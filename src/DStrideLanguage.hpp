@@ -0,0 +1,113 @@
+#pragma once
+
+#include "DRegularLanguage.hpp"
+
+#include <vector>
+#include <memory>
+#include <limits>
+
+namespace FACore {
+    
+    // Saturates at the largest unsigned long long instead of wrapping around
+    constexpr unsigned long long IntegerPower(unsigned long long base, unsigned int exponent, unsigned long long result = 1) {
+        return exponent == 0 ? result :
+               base != 0 && result > std::numeric_limits<unsigned long long>::max() / base ? std::numeric_limits<unsigned long long>::max() :
+               IntegerPower(base, exponent - 1, result * base);
+    }
+    
+    // A DRegularLanguage whose integer contains() consumes STRIDE digits per table lookup.
+    // Two tables of GetNumStates() * ALPHABET_SIZE^STRIDE entries are precomputed: one for
+    // full chunks of STRIDE digits and one for the final, shorter chunk, which must not
+    // read the leading zeros of the number. DStrideLanguage<2, 8> reads a byte at a time.
+    template<unsigned int ALPHABET_SIZE, unsigned int STRIDE, typename StateIdType = unsigned int>
+    class DStrideLanguage : public DRegularLanguage<ALPHABET_SIZE, StateIdType> {
+        public:
+            typedef DRegularLanguage<ALPHABET_SIZE, StateIdType> Base;
+            typedef typename Base::Machine Machine;
+            typedef typename Base::StateId StateId;
+            typedef typename Base::Character Character;
+            
+            static_assert(STRIDE > 0, "The stride must consume at least one digit");
+            static_assert(IntegerPower(ALPHABET_SIZE, STRIDE) <= (1u << 24), "The stride table would have more than 2^24 entries per state");
+            
+            // Number of distinct values of STRIDE digits
+            constexpr static unsigned int CHUNK_SIZE = static_cast<unsigned int>(IntegerPower(ALPHABET_SIZE, STRIDE));
+            
+            DStrideLanguage(std::shared_ptr<const Machine> automaton, StateId initialState) : Base(automaton, initialState)
+            {
+                BuildTables();
+            }
+            
+            DStrideLanguage(Machine* automaton, StateId initialState) : DStrideLanguage(std::shared_ptr<const Machine>(automaton), initialState)
+            {}
+            
+            DStrideLanguage(DStrideLanguage&& other) = default;
+            
+            using Base::contains;
+            
+            virtual bool contains(unsigned int number) {
+                const Machine &automaton = *this->GetAutomaton();
+                if(mTablesGeneration != automaton.GetGeneration()) {
+                    BuildTables();
+                }
+                StateId currentState = this->GetInitialState();
+                if(!automaton.IsValidState(currentState)) {
+                    return false;
+                }
+                
+                while(number >= CHUNK_SIZE) {
+                    currentState = mChunkTable[static_cast<std::size_t>(currentState) * CHUNK_SIZE + number % CHUNK_SIZE];
+                    if(currentState == Machine::INVALID_STATE) {
+                        return false;
+                    }
+                    number /= CHUNK_SIZE;
+                }
+                currentState = mTailTable[static_cast<std::size_t>(currentState) * CHUNK_SIZE + number];
+                return automaton.IsFinal(currentState);
+            }
+            
+            // Memory taken by the stride tables
+            std::size_t GetTableSize() const {
+                return (mChunkTable.size() + mTailTable.size()) * sizeof(StateId);
+            }
+        
+        private:
+            void BuildTables() {
+                const Machine &automaton = *this->GetAutomaton();
+                const std::size_t numStates = automaton.GetNumStates();
+                
+                mChunkTable.resize(numStates * CHUNK_SIZE);
+                mTailTable.resize(numStates * CHUNK_SIZE);
+                for(StateId src = 0; src < numStates; src++) {
+                    for(unsigned int chunk = 0; chunk < CHUNK_SIZE; chunk++) {
+                        // The full chunk reads exactly STRIDE digits, zeros included
+                        StateId currentState = src;
+                        unsigned int value = chunk;
+                        for(unsigned int digit = 0; digit < STRIDE; digit++) {
+                            currentState = automaton.GetNext(currentState, value % ALPHABET_SIZE);
+                            value /= ALPHABET_SIZE;
+                        }
+                        mChunkTable[static_cast<std::size_t>(src) * CHUNK_SIZE + chunk] = currentState;
+                        
+                        // The tail stops at the most significant non-zero digit, like DigitIterator
+                        currentState = src;
+                        for(value = chunk; value != 0; value /= ALPHABET_SIZE) {
+                            currentState = automaton.GetNext(currentState, value % ALPHABET_SIZE);
+                        }
+                        mTailTable[static_cast<std::size_t>(src) * CHUNK_SIZE + chunk] = currentState;
+                    }
+                }
+                mTablesGeneration = automaton.GetGeneration();
+            }
+            
+            // Indexed by state * CHUNK_SIZE + chunk
+            std::vector<StateId> mChunkTable;
+            std::vector<StateId> mTailTable;
+            
+            // Generation of the automaton the tables were built from, they are rebuilt once it changes
+            std::size_t mTablesGeneration;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, unsigned int STRIDE, typename StateIdType>
+    constexpr unsigned int DStrideLanguage<ALPHABET_SIZE, STRIDE, StateIdType>::CHUNK_SIZE;
+}
\ No newline at end of file
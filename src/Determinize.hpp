@@ -0,0 +1,60 @@
+#pragma once
+
+#include "NAutomaton.hpp"
+#include "DAutomaton.hpp"
+#include "NRegularLanguage.hpp"
+#include "DRegularLanguage.hpp"
+#include "utils/SubsetConstruction.hpp"
+
+#include <set>
+#include <memory>
+
+namespace FACore {
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    struct DeterminizeResult {
+        DAutomaton<ALPHABET_SIZE, StateIdType> automaton;
+        typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState;
+    };
+    
+    // Subset construction over the SubsetStates of utils/SubsetConstruction.hpp.
+    // Only subsets reachable from the initial set are built, numbered in BFS order.
+    // The empty subset is never materialized, arcs into it are left as INVALID_STATE.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    DeterminizeResult<ALPHABET_SIZE, StateIdType> Determinize(const NAutomaton<ALPHABET_SIZE, StateIdType> &nfa, const std::set<typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId> &initialStates) {
+        typedef SubsetStates<ALPHABET_SIZE, StateIdType> States;
+        typedef typename States::DMachine DMachine;
+        typedef typename States::DStateId DStateId;
+        typedef typename States::Subset Subset;
+        
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> result;
+        States states(nfa, result.automaton);
+        
+        Subset initial = states.GetInitialSubset(initialStates);
+        if(initial.none()) {
+            result.initialState = DMachine::INVALID_STATE;
+            return result;
+        }
+        result.initialState = states.Intern(initial);
+        
+        Subset next(nfa.GetNumStates());
+        for(DStateId current = 0; current < states.GetNumSubsets(); current++) {
+            for(typename DMachine::Label label = 0; label < ALPHABET_SIZE; label++) {
+                states.GetSuccessors(states.GetSubset(current), label, next);
+                if(next.any()) {
+                    result.automaton.SetArc(current, label, states.Intern(next));
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> Determinize(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> determinized = Determinize(*language.GetAutomaton(), language.GetInitialStates());
+        
+        std::shared_ptr<const DAutomaton<ALPHABET_SIZE, StateIdType> > automaton(new DAutomaton<ALPHABET_SIZE, StateIdType>(std::move(determinized.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>(automaton, determinized.initialState);
+    }
+}
\ No newline at end of file
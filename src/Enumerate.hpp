@@ -0,0 +1,371 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "NAutomatonBuilder.hpp"
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+#include "Determinize.hpp"
+
+#include <set>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // Yields the words of a language in shortlex order: shorter words first, words of
+    // the same length in lexicographic order of their labels. Each word is unranked from
+    // per-state path counts, counts[r][s] being the number of accepted words of length r
+    // from s, so states that cannot complete a word of the needed length are never
+    // entered and Next costs O(length * ALPHABET_SIZE) whatever the rejected words are.
+    // Path counts saturate at 2^64 - 1; enumerating or skipping past that many words of
+    // one length is not supported.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    class WordEnumerator {
+        public:
+            typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+            typedef typename Machine::StateId StateId;
+            typedef typename Machine::Label Label;
+            typedef std::uint64_t PathCount;
+            
+            constexpr static PathCount SATURATED = std::numeric_limits<PathCount>::max();
+            
+            // With nonZeroFirstLabel, non empty words starting with label 0 are left out
+            WordEnumerator(std::shared_ptr<const Machine> automaton, StateId initialState, bool nonZeroFirstLabel = false) :
+                mAutomaton(automaton), mInitialState(initialState), mFirstLabel(nonZeroFirstLabel ? 1 : 0),
+                mLength(0), mRank(0), mFinished(false)
+            {
+                FindLiveStates();
+                mFinished = !mAutomaton->IsValidState(mInitialState);
+            }
+            
+            template<class Instrumentation>
+            explicit WordEnumerator(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) : WordEnumerator(language.GetAutomaton(), language.GetInitialState())
+            {}
+            
+            // The NAutomaton is determinized up front
+            template<class Instrumentation>
+            explicit WordEnumerator(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) : WordEnumerator(Determinize(language))
+            {}
+            
+            WordEnumerator(WordEnumerator&& other) = default;
+            
+            // Replaces word with the next accepted word, false once there are none left
+            bool Next(std::vector<Label> &word) {
+                if(!Seek()) {
+                    return false;
+                }
+                
+                word.resize(mLength);
+                PathCount rank = mRank;
+                StateId state = mInitialState;
+                for(std::size_t position = 0; position < mLength; position++) {
+                    const std::size_t remaining = mLength - position - 1;
+                    for(Label label = position == 0 ? mFirstLabel : 0; label < ALPHABET_SIZE; label++) {
+                        StateId next = mAutomaton->GetNext(state, label);
+                        if(next == Machine::INVALID_STATE) {
+                            continue;
+                        }
+                        PathCount count = GetCount(next, remaining);
+                        if(rank < count) {
+                            word[position] = label;
+                            state = next;
+                            break;
+                        }
+                        rank -= count;
+                    }
+                }
+                mRank++;
+                return true;
+            }
+            
+            // Drops the next count words, in O(count of lengths passed * states * ALPHABET_SIZE)
+            void Skip(std::uint64_t count) {
+                mRank = mRank > SATURATED - count ? SATURATED : mRank + count;
+                Seek();
+            }
+            
+            // Whether the language has infinitely many words
+            bool IsInfinite() const {
+                return mInfinite;
+            }
+        
+        private:
+            // Moves on to the length holding the word of rank mRank, false when there is none
+            bool Seek() {
+                while(!mFinished) {
+                    PathCount total = GetTotal(mLength);
+                    if(mRank < total) {
+                        return true;
+                    }
+                    mRank -= total;
+                    mLength++;
+                    // A word of a finite language visits each live state at most once
+                    mFinished = !mInfinite && mLength > mNumLive;
+                }
+                return false;
+            }
+            
+            // Number of words of the given length from the initial state
+            PathCount GetTotal(std::size_t length) {
+                if(length == 0) {
+                    return mAutomaton->IsFinal(mInitialState) ? 1 : 0;
+                }
+                PathCount total = 0;
+                for(Label label = mFirstLabel; label < ALPHABET_SIZE; label++) {
+                    StateId next = mAutomaton->GetNext(mInitialState, label);
+                    if(next != Machine::INVALID_STATE) {
+                        total = SaturatingAdd(total, GetCount(next, length - 1));
+                    }
+                }
+                return total;
+            }
+            
+            PathCount GetCount(StateId state, std::size_t length) {
+                const StateId numStates = mAutomaton->GetNumStates();
+                while(mCounts.size() <= length) {
+                    std::vector<PathCount> counts(numStates, 0);
+                    for(StateId src = 0; src < numStates; src++) {
+                        if(!mLive[src]) {
+                            continue;
+                        }
+                        if(mCounts.empty()) {
+                            counts[src] = mAutomaton->IsFinal(src) ? 1 : 0;
+                            continue;
+                        }
+                        for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                            StateId next = mAutomaton->GetNext(src, label);
+                            if(next != Machine::INVALID_STATE) {
+                                counts[src] = SaturatingAdd(counts[src], mCounts.back()[next]);
+                            }
+                        }
+                    }
+                    mCounts.push_back(std::move(counts));
+                }
+                return mCounts[length][state];
+            }
+            
+            static PathCount SaturatingAdd(PathCount left, PathCount right) {
+                return left > SATURATED - right ? SATURATED : left + right;
+            }
+            
+            // Live states are reachable after the first label and co-reachable from a final
+            // state. After its first label a word only runs through live states, so the
+            // language is infinite iff the live states contain a cycle.
+            void FindLiveStates() {
+                const StateId numStates = mAutomaton->GetNumStates();
+                mLive.resize(numStates);
+                mNumLive = 0;
+                mInfinite = false;
+                if(!mAutomaton->IsValidState(mInitialState)) {
+                    return;
+                }
+                
+                boost::dynamic_bitset<> reachable(numStates);
+                std::vector<StateId> stack;
+                for(Label label = mFirstLabel; label < ALPHABET_SIZE; label++) {
+                    StateId next = mAutomaton->GetNext(mInitialState, label);
+                    if(next != Machine::INVALID_STATE && !reachable[next]) {
+                        reachable.set(next);
+                        stack.push_back(next);
+                    }
+                }
+                std::vector<std::vector<StateId> > predecessors(numStates);
+                while(!stack.empty()) {
+                    StateId state = stack.back();
+                    stack.pop_back();
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        StateId next = mAutomaton->GetNext(state, label);
+                        if(next == Machine::INVALID_STATE) {
+                            continue;
+                        }
+                        predecessors[next].push_back(state);
+                        if(!reachable[next]) {
+                            reachable.set(next);
+                            stack.push_back(next);
+                        }
+                    }
+                }
+                
+                for(StateId state = 0; state < numStates; state++) {
+                    if(reachable[state] && mAutomaton->IsFinal(state)) {
+                        mLive.set(state);
+                        stack.push_back(state);
+                    }
+                }
+                while(!stack.empty()) {
+                    StateId state = stack.back();
+                    stack.pop_back();
+                    for(StateId previous : predecessors[state]) {
+                        if(!mLive[previous]) {
+                            mLive.set(previous);
+                            stack.push_back(previous);
+                        }
+                    }
+                }
+                mNumLive = mLive.count();
+                
+                // Kahn's algorithm over the live states, a cycle leaves some of them unsorted
+                std::vector<std::size_t> inDegree(numStates, 0);
+                for(StateId state = 0; state < numStates; state++) {
+                    if(!mLive[state]) {
+                        continue;
+                    }
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        StateId next = mAutomaton->GetNext(state, label);
+                        if(next != Machine::INVALID_STATE && mLive[next]) {
+                            inDegree[next]++;
+                        }
+                    }
+                }
+                for(StateId state = 0; state < numStates; state++) {
+                    if(mLive[state] && inDegree[state] == 0) {
+                        stack.push_back(state);
+                    }
+                }
+                std::size_t sorted = 0;
+                while(!stack.empty()) {
+                    StateId state = stack.back();
+                    stack.pop_back();
+                    sorted++;
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        StateId next = mAutomaton->GetNext(state, label);
+                        if(next != Machine::INVALID_STATE && mLive[next] && --inDegree[next] == 0) {
+                            stack.push_back(next);
+                        }
+                    }
+                }
+                mInfinite = sorted < mNumLive;
+            }
+            
+            std::shared_ptr<const Machine> mAutomaton;
+            StateId mInitialState;
+            Label mFirstLabel;
+            
+            boost::dynamic_bitset<> mLive;
+            std::size_t mNumLive;
+            bool mInfinite;
+            
+            // Indexed by length, then state; grown on demand
+            std::vector<std::vector<PathCount> > mCounts;
+            
+            // The next word is the word of rank mRank among those of length mLength
+            std::size_t mLength;
+            PathCount mRank;
+            bool mFinished;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    constexpr typename WordEnumerator<ALPHABET_SIZE, StateIdType>::PathCount WordEnumerator<ALPHABET_SIZE, StateIdType>::SATURATED;
+    
+    // Yields the numbers of a language in increasing order, under the DigitIterator
+    // encoding. Increasing numbers are shortlex ordered digit strings read most
+    // significant digit first, so the automaton is reversed and determinized, and its
+    // words without a leading zero are enumerated with a WordEnumerator. The reversed
+    // automaton can in the worst case be exponentially larger than the original one.
+    // NumberType may be any unsigned builtin, unsigned __int128 or cpp_int.
+    template<unsigned int ALPHABET_SIZE, typename NumberType = std::uint64_t, typename StateIdType = unsigned int>
+    class NumberEnumerator {
+        public:
+            typedef WordEnumerator<ALPHABET_SIZE, StateIdType> Words;
+            typedef typename Words::Machine Machine;
+            typedef typename Words::StateId StateId;
+            typedef typename Words::Label Label;
+            
+            template<class Instrumentation>
+            explicit NumberEnumerator(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) :
+                mDigits(Reverse(*language.GetAutomaton(), {language.GetInitialState()}))
+            {}
+            
+            template<class Instrumentation>
+            explicit NumberEnumerator(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) :
+                mDigits(Reverse(*language.GetAutomaton(), language.GetInitialStates()))
+            {}
+            
+            NumberEnumerator(NumberEnumerator&& other) = default;
+            
+            // Throws std::out_of_range if the next number does not fit NumberType
+            bool Next(NumberType &number) {
+                if(!mDigits.Next(mWord)) {
+                    return false;
+                }
+                NumberType value = 0;
+                for(Label digit : mWord) {
+                    NumberType shifted = value * ALPHABET_SIZE + digit;
+                    if(shifted / ALPHABET_SIZE != value) {
+                        throw std::out_of_range("Number does not fit NumberType");
+                    }
+                    value = shifted;
+                }
+                number = value;
+                return true;
+            }
+            
+            void Skip(std::uint64_t count) {
+                mDigits.Skip(count);
+            }
+            
+            bool IsInfinite() const {
+                return mDigits.IsInfinite();
+            }
+        
+        private:
+            typedef NAutomatonBuilder<ALPHABET_SIZE, StateIdType> Builder;
+            
+            // Swaps initial and final states and turns every arc around
+            template<class Automaton>
+            static Words Reverse(const Automaton &automaton, const std::set<StateId> &initialStates) {
+                Builder builder;
+                std::set<StateId> finalStates;
+                for(StateId state = 0; state < automaton.GetNumStates(); state++) {
+                    builder.AddState(initialStates.count(state) != 0);
+                    if(automaton.IsFinal(state)) {
+                        finalStates.insert(state);
+                    }
+                }
+                for(StateId state = 0; state < automaton.GetNumStates(); state++) {
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        AddReversedArcs(builder, state, label, automaton.GetNext(state, label));
+                    }
+                }
+                AddReversedEpsilonArcs(builder, automaton);
+                
+                DeterminizeResult<ALPHABET_SIZE, StateIdType> determinized = Determinize(builder.Freeze(), finalStates);
+                std::shared_ptr<const Machine> reversed(new Machine(std::move(determinized.automaton)));
+                return Words(reversed, determinized.initialState, true);
+            }
+            
+            static void AddReversedArcs(Builder &builder, StateId src, Label label, StateId dest) {
+                if(dest != Machine::INVALID_STATE) {
+                    builder.AddArc(dest, label, src);
+                }
+            }
+            
+            template<class Range>
+            static void AddReversedArcs(Builder &builder, StateId src, Label label, const Range &arcs) {
+                for(auto &arc : arcs) {
+                    builder.AddArc(ArcDestination(arc), label, src);
+                }
+            }
+            
+            // A DAutomaton has no epsilon arcs
+            static void AddReversedEpsilonArcs(Builder &, const Machine &) {
+            }
+            
+            static void AddReversedEpsilonArcs(Builder &builder, const NAutomaton<ALPHABET_SIZE, StateIdType> &automaton) {
+                for(StateId state = 0; state < automaton.GetNumStates(); state++) {
+                    for(auto &arc : automaton.GetEpsilonNext(state)) {
+                        builder.AddEpsilonArc(arc.second, state);
+                    }
+                }
+            }
+            
+            Words mDigits;
+            std::vector<Label> mWord;
+    };
+}
\ No newline at end of file
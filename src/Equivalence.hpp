@@ -0,0 +1,332 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+#include "Determinize.hpp"
+
+#include <set>
+#include <deque>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace FACore {
+    
+    struct LanguageCheckResult {
+        bool holds;
+        
+        // A shortest word showing that the check does not hold, empty when it holds.
+        // For IsEmpty it is a shortest word of the language.
+        std::vector<unsigned int> counterexample;
+        
+        explicit operator bool() const {
+            return holds;
+        }
+    };
+    
+    // BFS over the pairs of states reachable from (leftInitial, rightInitial), INVALID_STATE
+    // included as an ordinary sink. Returns a shortest word leading to a pair for which
+    // isWitness(leftFinal, rightFinal) holds. Pairs where isDead(leftInvalid, rightInvalid)
+    // holds are not expanded, as no witness can be reached from them.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, typename WitnessPredicate, typename DeadPredicate>
+    LanguageCheckResult FindShortestWitness(
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &left, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId leftInitial,
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &right, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId rightInitial,
+        WitnessPredicate isWitness, DeadPredicate isDead)
+    {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        typedef std::pair<StateId, StateId> StatePair;
+        
+        struct Visit {
+            StatePair pair;
+            std::size_t parent;
+            Label label;
+        };
+        
+        std::unordered_map<StatePair, std::size_t, boost::hash<StatePair> > seen;
+        std::vector<Visit> visits;
+        
+        StatePair initial(
+            left.IsValidState(leftInitial) ? leftInitial : Machine::INVALID_STATE,
+            right.IsValidState(rightInitial) ? rightInitial : Machine::INVALID_STATE);
+        seen.emplace(initial, 0);
+        visits.push_back(Visit {initial, 0, 0});
+        
+        for(std::size_t current = 0; current < visits.size(); current++) {
+            const StatePair pair = visits[current].pair;
+            if(isWitness(left.IsFinal(pair.first), right.IsFinal(pair.second))) {
+                LanguageCheckResult result {false, {}};
+                for(std::size_t visit = current; visit != 0; visit = visits[visit].parent) {
+                    result.counterexample.push_back(visits[visit].label);
+                }
+                std::reverse(result.counterexample.begin(), result.counterexample.end());
+                return result;
+            }
+            if(isDead(pair.first == Machine::INVALID_STATE, pair.second == Machine::INVALID_STATE)) {
+                continue;
+            }
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                StatePair next(left.GetNext(pair.first, label), right.GetNext(pair.second, label));
+                if(seen.emplace(next, visits.size()).second) {
+                    visits.push_back(Visit {next, current, label});
+                }
+            }
+        }
+        
+        return LanguageCheckResult {true, {}};
+    }
+    
+    // Holds if the language accepted from initialState is empty, otherwise the
+    // counterexample is a shortest accepted word.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    LanguageCheckResult IsEmpty(const DAutomaton<ALPHABET_SIZE, StateIdType> &automaton, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        if(!automaton.IsValidState(initialState)) {
+            return LanguageCheckResult {true, {}};
+        }
+        
+        // BFS tree, parent[state] is INVALID_STATE until the state is reached
+        std::vector<StateId> parent(automaton.GetNumStates(), Machine::INVALID_STATE);
+        std::vector<Label> parentLabel(automaton.GetNumStates(), 0);
+        std::vector<StateId> queue(1, initialState);
+        parent[initialState] = initialState;
+        
+        for(std::size_t current = 0; current < queue.size(); current++) {
+            StateId state = queue[current];
+            if(automaton.IsFinal(state)) {
+                LanguageCheckResult result {false, {}};
+                for(; state != initialState; state = parent[state]) {
+                    result.counterexample.push_back(parentLabel[state]);
+                }
+                std::reverse(result.counterexample.begin(), result.counterexample.end());
+                return result;
+            }
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                StateId next = automaton.GetNext(state, label);
+                if(next != Machine::INVALID_STATE && parent[next] == Machine::INVALID_STATE) {
+                    parent[next] = state;
+                    parentLabel[next] = label;
+                    queue.push_back(next);
+                }
+            }
+        }
+        
+        return LanguageCheckResult {true, {}};
+    }
+    
+    // Holds if no word is accepted from initialStates, otherwise the counterexample is a
+    // shortest accepted word. Epsilon arcs add nothing to the length of a word, so this is
+    // a 0-1 BFS: states reached over them go to the front of the queue. Each state is
+    // expanded once, in time linear in the number of states and arcs.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    LanguageCheckResult IsEmpty(const NAutomaton<ALPHABET_SIZE, StateIdType> &automaton, const std::set<typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId> &initialStates) {
+        typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        // Label of the arcs into a state that were epsilon arcs
+        const Label EPSILON = ALPHABET_SIZE;
+        const std::size_t UNREACHED = std::numeric_limits<std::size_t>::max();
+        
+        // BFS tree, an initial state is its own parent
+        std::vector<std::size_t> length(automaton.GetNumStates(), UNREACHED);
+        std::vector<StateId> parent(automaton.GetNumStates(), Machine::INVALID_STATE);
+        std::vector<Label> parentLabel(automaton.GetNumStates(), EPSILON);
+        boost::dynamic_bitset<> expanded(automaton.GetNumStates());
+        std::deque<StateId> queue;
+        for(StateId state : initialStates) {
+            if(automaton.IsValidState(state)) {
+                length[state] = 0;
+                parent[state] = state;
+                queue.push_back(state);
+            }
+        }
+        
+        while(!queue.empty()) {
+            StateId state = queue.front();
+            queue.pop_front();
+            if(expanded[state]) {
+                continue;
+            }
+            expanded.set(state);
+            
+            if(automaton.IsFinal(state)) {
+                LanguageCheckResult result {false, {}};
+                for(; parent[state] != state; state = parent[state]) {
+                    if(parentLabel[state] != EPSILON) {
+                        result.counterexample.push_back(parentLabel[state]);
+                    }
+                }
+                std::reverse(result.counterexample.begin(), result.counterexample.end());
+                return result;
+            }
+            for(auto &arc : automaton.GetEpsilonNext(state)) {
+                StateId next = arc.second;
+                if(length[state] < length[next]) {
+                    length[next] = length[state];
+                    parent[next] = state;
+                    parentLabel[next] = EPSILON;
+                    queue.push_front(next);
+                }
+            }
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                for(auto &arc : automaton.GetNext(state, label)) {
+                    StateId next = ArcDestination(arc);
+                    if(length[state] + 1 < length[next]) {
+                        length[next] = length[state] + 1;
+                        parent[next] = state;
+                        parentLabel[next] = label;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+        
+        return LanguageCheckResult {true, {}};
+    }
+    
+    // Holds if every word accepted from subInitial in sub is accepted from superInitial
+    // in super. Walks the reachable pairs once, O(n*m*k) in the worst case.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    LanguageCheckResult IsIncluded(
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &sub, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId subInitial,
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &super, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId superInitial)
+    {
+        return FindShortestWitness(sub, subInitial, super, superInitial,
+            [](bool subFinal, bool superFinal) { return subFinal && !superFinal; },
+            [](bool subInvalid, bool) { return subInvalid; });
+    }
+    
+    // Hopcroft-Karp: the two initial states are merged with union-find, and every merge
+    // of two classes pushes the pairs of successors on a stack. The languages differ iff
+    // some merged pair disagrees on finality. With n states in total this takes
+    // O(n*k*alpha(n)). Only when they differ is a BFS over pairs run to find a shortest
+    // counterexample.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    LanguageCheckResult AreEquivalent(
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &left, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId leftInitial,
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &right, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId rightInitial)
+    {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        // Left states, the left sink, right states, the right sink.
+        // Each sink stands in for INVALID_STATE of its automaton.
+        const std::size_t leftSink = left.GetNumStates();
+        const std::size_t rightOffset = leftSink + 1;
+        const std::size_t rightSink = rightOffset + right.GetNumStates();
+        
+        auto leftIndex = [&](StateId state) -> std::size_t {
+            return state == Machine::INVALID_STATE || !left.IsValidState(state) ? leftSink : state;
+        };
+        auto rightIndex = [&](StateId state) -> std::size_t {
+            return state == Machine::INVALID_STATE || !right.IsValidState(state) ? rightSink : rightOffset + state;
+        };
+        auto isFinal = [&](std::size_t index) -> bool {
+            if(index < leftSink) {
+                return left.IsFinal(index);
+            }
+            return index > leftSink && index < rightSink && right.IsFinal(index - rightOffset);
+        };
+        auto next = [&](std::size_t index, Label label) -> std::size_t {
+            if(index < leftSink) {
+                return leftIndex(left.GetNext(index, label));
+            }
+            if(index > leftSink && index < rightSink) {
+                return rightIndex(right.GetNext(index - rightOffset, label));
+            }
+            return index;
+        };
+        
+        std::vector<std::size_t> classes(rightSink + 1);
+        for(std::size_t index = 0; index < classes.size(); index++) {
+            classes[index] = index;
+        }
+        auto find = [&](std::size_t index) -> std::size_t {
+            while(classes[index] != index) {
+                classes[index] = classes[classes[index]];
+                index = classes[index];
+            }
+            return index;
+        };
+        
+        bool equivalent = true;
+        std::vector<std::pair<std::size_t, std::size_t> > pending;
+        pending.emplace_back(leftIndex(leftInitial), rightIndex(rightInitial));
+        while(!pending.empty()) {
+            std::size_t first = pending.back().first;
+            std::size_t second = pending.back().second;
+            pending.pop_back();
+            
+            std::size_t firstClass = find(first);
+            std::size_t secondClass = find(second);
+            if(firstClass == secondClass) {
+                continue;
+            }
+            if(isFinal(first) != isFinal(second)) {
+                equivalent = false;
+                break;
+            }
+            classes[firstClass] = secondClass;
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                pending.emplace_back(next(first, label), next(second, label));
+            }
+        }
+        
+        if(equivalent) {
+            return LanguageCheckResult {true, {}};
+        }
+        return FindShortestWitness(left, leftInitial, right, rightInitial,
+            [](bool leftFinal, bool rightFinal) { return leftFinal != rightFinal; },
+            [](bool leftInvalid, bool rightInvalid) { return leftInvalid && rightInvalid; });
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    LanguageCheckResult IsEmpty(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        return IsEmpty(*language.GetAutomaton(), language.GetInitialState());
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    LanguageCheckResult IsIncluded(const DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &sub, const DRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &super) {
+        return IsIncluded(*sub.GetAutomaton(), sub.GetInitialState(), *super.GetAutomaton(), super.GetInitialState());
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    LanguageCheckResult AreEquivalent(const DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &left, const DRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &right) {
+        return AreEquivalent(*left.GetAutomaton(), left.GetInitialState(), *right.GetAutomaton(), right.GetInitialState());
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    LanguageCheckResult IsEmpty(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        return IsEmpty(*language.GetAutomaton(), language.GetInitialStates());
+    }
+    
+    // Inclusion and equivalence of NAutomaton backed languages determinize both first,
+    // which may take exponential time
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    LanguageCheckResult IsIncluded(const NRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &sub, const NRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &super) {
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> determinizedSub = Determinize(*sub.GetAutomaton(), sub.GetInitialStates());
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> determinizedSuper = Determinize(*super.GetAutomaton(), super.GetInitialStates());
+        return IsIncluded(determinizedSub.automaton, determinizedSub.initialState, determinizedSuper.automaton, determinizedSuper.initialState);
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    LanguageCheckResult AreEquivalent(const NRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &left, const NRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &right) {
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> determinizedLeft = Determinize(*left.GetAutomaton(), left.GetInitialStates());
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> determinizedRight = Determinize(*right.GetAutomaton(), right.GetInitialStates());
+        return AreEquivalent(determinizedLeft.automaton, determinizedLeft.initialState, determinizedRight.automaton, determinizedRight.initialState);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "Serialization.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace FACore {
+    
+    // A read-only DAutomaton served straight from a file written by SaveAutomaton.
+    // The file is mapped, not read, so opening it costs the same for any number of
+    // states, and processes mapping the same file share its pages. Only the header
+    // and the file size are checked, destinations are not, so files must come from
+    // a trusted writer; GetNext and IsFinal still never read outside the mapping.
+    // DRegularLanguage, DMatcher and CompiledMatcher query it in place, see MappedDRegularLanguage.
+    template<unsigned int AlphabetSize, typename StateIdType = unsigned int>
+    class MappedDAutomaton {
+        public:
+            typedef DAutomaton<AlphabetSize, StateIdType> Machine;
+            
+            typedef typename Machine::StateId StateId;
+            typedef typename Machine::Label Label;
+            typedef typename Machine::TransitionArr TransitionArr;
+            
+            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
+            constexpr static StateId INVALID_STATE = Machine::INVALID_STATE;
+            
+            explicit MappedDAutomaton(const std::string &path) :
+                mFile(path.c_str(), boost::interprocess::read_only),
+                mRegion(mFile, boost::interprocess::read_only)
+            {
+                const char *base = static_cast<const char*>(mRegion.get_address());
+                const std::uint64_t size = mRegion.get_size();
+                if(size < sizeof(AutomatonFileHeader)) {
+                    throw std::runtime_error("Automaton file is truncated");
+                }
+                
+                const AutomatonFileHeader &header = *reinterpret_cast<const AutomatonFileHeader*>(base);
+                CheckAutomatonFileHeader(header, AutomatonKind::Deterministic, ALPHABET_SIZE, sizeof(StateId), INVALID_STATE);
+                
+                if(header.numStates > (size - sizeof(AutomatonFileHeader)) / sizeof(TransitionArr)) {
+                    throw std::runtime_error("Automaton file is truncated");
+                }
+                const std::uint64_t tableSize = header.numStates * sizeof(TransitionArr);
+                const std::uint64_t finalOffset = sizeof(AutomatonFileHeader) + tableSize + AutomatonFilePadding(tableSize);
+                if(size < finalOffset + AutomatonFileFinalWords(header.numStates) * sizeof(std::uint64_t)) {
+                    throw std::runtime_error("Automaton file is truncated");
+                }
+                
+                mNumStates = header.numStates;
+                mTransitions = reinterpret_cast<const TransitionArr*>(base + sizeof(AutomatonFileHeader));
+                mFinalWords = reinterpret_cast<const std::uint64_t*>(base + finalOffset);
+            }
+            
+            MappedDAutomaton(MappedDAutomaton&& other) = default;
+            
+            bool IsValidState(StateId state) const {
+                return state < mNumStates;
+            }
+            
+            bool IsValidLabel(Label label) const {
+                return label < ALPHABET_SIZE;
+            }
+            
+            StateId GetNumStates() const {
+                return mNumStates;
+            }
+            
+            StateId GetNext(StateId src, Label label) const {
+                if(IsValidState(src) && IsValidLabel(label)) {
+                    return mTransitions[src][label];
+                } else {
+                    return INVALID_STATE;
+                }
+            }
+            
+            // Rows are indexed by StateId, entries by Label. No bounds checking, intended for hot loops.
+            const TransitionArr* GetTransitionTable() const {
+                return mTransitions;
+            }
+            
+            bool IsFinal(StateId state) const {
+                if(!IsValidState(state)) {
+                    return false;
+                }
+                return (mFinalWords[state / 64] >> (state % 64)) & 1;
+            }
+            
+            // The mapping is read-only, so anything derived from it never goes stale
+            std::size_t GetGeneration() const {
+                return 0;
+            }
+        
+        private:
+            boost::interprocess::file_mapping mFile;
+            boost::interprocess::mapped_region mRegion;
+            
+            StateId mNumStates;
+            const TransitionArr *mTransitions;
+            const std::uint64_t *mFinalWords;
+    };
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr unsigned int MappedDAutomaton<AlphabetSize, StateIdType>::ALPHABET_SIZE;
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr typename MappedDAutomaton<AlphabetSize, StateIdType>::StateId MappedDAutomaton<AlphabetSize, StateIdType>::INVALID_STATE;
+    
+    // A language queried straight from the mapped file, without copying its table
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int, class Instrumentation = NoInstrumentation>
+    using MappedDRegularLanguage = DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation, MappedDAutomaton<ALPHABET_SIZE, StateIdType> >;
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+#include "utils/EpsilonClosure.hpp"
+
+#include <set>
+#include <vector>
+#include <memory>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // Matches a word that arrives in pieces. The current state is kept between calls to
+    // feed, so each chunk is read where it lies and nothing is buffered: feeding the
+    // chunks of a word one after the other and then asking isAccepting gives the same
+    // answer as contains over the whole word. Automaton is a DAutomaton or a read-only
+    // automaton with the same queries, like MappedDAutomaton.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int, class Automaton = DAutomaton<ALPHABET_SIZE, StateIdType> >
+    class DMatcher {
+        public:
+            typedef Automaton Machine;
+            
+            typedef typename Machine::Label Character;
+            typedef typename Machine::StateId StateId;
+            
+            DMatcher(std::shared_ptr<const Machine> automaton, StateId initialState) : mAutomaton(automaton), mInitialState(initialState), mCurrentState(initialState)
+            {}
+            
+            // Any Instrumentation policy, the matcher records nothing
+            template<class Instrumentation>
+            explicit DMatcher(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation, Automaton> &language) : DMatcher(language.GetAutomaton(), language.GetInitialState())
+            {}
+            
+            template<typename IterType>
+            void feed(IterType begin, IterType end) {
+                StateId currentState = mCurrentState;
+                for(auto iter = begin; iter != end && currentState != Machine::INVALID_STATE; ++iter) {
+                    Character c = *iter;
+                    currentState = mAutomaton->GetNext(currentState, c);
+                }
+                mCurrentState = currentState;
+            }
+            
+            bool isAccepting() const {
+                return mAutomaton->IsFinal(mCurrentState);
+            }
+            
+            // No continuation of the input fed so far can be accepted any more
+            bool isDead() const {
+                return mCurrentState == Machine::INVALID_STATE;
+            }
+            
+            // Starts over with the empty word
+            void reset() {
+                mCurrentState = mInitialState;
+            }
+            
+            StateId GetCurrentState() const {
+                return mCurrentState;
+            }
+        
+        private:
+            std::shared_ptr<const Machine> mAutomaton;
+            StateId mInitialState;
+            StateId mCurrentState;
+    };
+    
+    // The NAutomaton counterpart of DMatcher. Active states are kept as a list plus a
+    // membership bitset, both sized to the automaton up front, so feeding allocates
+    // nothing and each step only touches the active states and their arcs.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    class NMatcher {
+        public:
+            typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+            
+            typedef typename Machine::Label Character;
+            typedef typename Machine::StateId StateId;
+            
+            typedef EpsilonClosure<Machine> Closure;
+            
+            NMatcher(std::shared_ptr<const Machine> automaton, const std::set<StateId> &initialStates) :
+                NMatcher(automaton, std::make_shared<const Closure>(*automaton), initialStates)
+            {}
+            
+            // Shares the closures of the language. Any Instrumentation policy, the matcher records nothing.
+            template<class Instrumentation>
+            explicit NMatcher(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) :
+                NMatcher(language.GetAutomaton(), language.GetEpsilonClosure(), language.GetInitialStates())
+            {}
+            
+            template<typename IterType>
+            void feed(IterType begin, IterType end) {
+                for(auto iter = begin; iter != end && !mCurrent.empty(); ++iter) {
+                    Character c = *iter;
+                    if(!mAutomaton->IsValidLabel(c)) {
+                        Clear(mCurrent, mCurrentMembers);
+                        break;
+                    }
+                    for(StateId src : mCurrent) {
+                        for(auto &arc : mAutomaton->GetNext(src, c)) {
+                            for(StateId dest : mClosure->GetClosure(ArcDestination(arc))) {
+                                Add(mNext, mNextMembers, dest);
+                            }
+                        }
+                    }
+                    Clear(mCurrent, mCurrentMembers);
+                    mCurrent.swap(mNext);
+                    mCurrentMembers.swap(mNextMembers);
+                }
+            }
+            
+            bool isAccepting() const {
+                for(StateId state : mCurrent) {
+                    if(mAutomaton->IsFinal(state)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            
+            bool isDead() const {
+                return mCurrent.empty();
+            }
+            
+            void reset() {
+                Clear(mCurrent, mCurrentMembers);
+                for(StateId state : mStartStates) {
+                    Add(mCurrent, mCurrentMembers, state);
+                }
+            }
+            
+            // Active states, closed over epsilon arcs, in no particular order
+            const std::vector<StateId>& GetActiveStates() const {
+                return mCurrent;
+            }
+        
+        private:
+            typedef boost::dynamic_bitset<> StateMask;
+            
+            NMatcher(std::shared_ptr<const Machine> automaton, std::shared_ptr<const Closure> closure, const std::set<StateId> &initialStates) :
+                mAutomaton(automaton), mClosure(closure),
+                mCurrentMembers(automaton->GetNumStates()), mNextMembers(automaton->GetNumStates())
+            {
+                mCurrent.reserve(automaton->GetNumStates());
+                mNext.reserve(automaton->GetNumStates());
+                for(StateId state : initialStates) {
+                    if(mAutomaton->IsValidState(state)) {
+                        for(StateId member : mClosure->GetClosure(state)) {
+                            Add(mCurrent, mCurrentMembers, member);
+                        }
+                    }
+                }
+                mStartStates = mCurrent;
+            }
+            
+            static void Add(std::vector<StateId> &states, StateMask &members, StateId state) {
+                if(!members[state]) {
+                    members.set(state);
+                    states.push_back(state);
+                }
+            }
+            
+            // Resets only the bits that are set, in O(active states)
+            static void Clear(std::vector<StateId> &states, StateMask &members) {
+                for(StateId state : states) {
+                    members.reset(state);
+                }
+                states.clear();
+            }
+            
+            std::shared_ptr<const Machine> mAutomaton;
+            std::shared_ptr<const Closure> mClosure;
+            
+            std::vector<StateId> mStartStates;
+            std::vector<StateId> mCurrent;
+            std::vector<StateId> mNext;
+            StateMask mCurrentMembers;
+            StateMask mNextMembers;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "utils/PartitionRefinement.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace FACore {
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    struct MinimizeResult {
+        DAutomaton<ALPHABET_SIZE, StateIdType> automaton;
+        typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState;
+        
+        // Reachable states that were folded into an equivalent state (or into INVALID_STATE)
+        typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId mergedStates;
+        
+        // States that could not be reached from the initial state and were dropped
+        typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId unreachableStates;
+    };
+    
+    // Hopcroft partition refinement, O(n*k*log n).
+    // The input is restricted to the states reachable from initialState and completed
+    // with an implicit sink standing in for INVALID_STATE. Every state that ends up
+    // equivalent to the sink is mapped back to INVALID_STATE, and the remaining
+    // blocks are renumbered in BFS order from the initial state.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    MinimizeResult<ALPHABET_SIZE, StateIdType> Minimize(const DAutomaton<ALPHABET_SIZE, StateIdType> &dfa, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::Label Label;
+        
+        MinimizeResult<ALPHABET_SIZE, StateIdType> result;
+        result.initialState = Machine::INVALID_STATE;
+        result.mergedStates = 0;
+        result.unreachableStates = dfa.GetNumStates();
+        
+        if(!dfa.IsValidState(initialState)) {
+            return result;
+        }
+        
+        const CompletedReachableStates<ALPHABET_SIZE, StateIdType> states(dfa, initialState);
+        typedef typename CompletedReachableStates<ALPHABET_SIZE, StateIdType>::Index Index;
+        const Index reachable = states.GetNumReachable();
+        const Index numStates = states.GetNumStates();
+        result.unreachableStates = dfa.GetNumStates() - reachable;
+        
+        auto target = [&](Index state, Label label) -> Index {
+            return states.GetNext(state, label);
+        };
+        const InverseTransitions<ALPHABET_SIZE, Index> inverse(numStates, target);
+        HopcroftPartition<ALPHABET_SIZE, Index> partition(numStates, [&](Index state) { return states.IsFinal(state); });
+        
+        std::vector<Index> splitter;
+        while(partition.HasSplitters()) {
+            auto next = partition.PopSplitter();
+            Index block = next.first;
+            Label label = next.second;
+            
+            // Marking reorders the block itself, so the splitter is copied first
+            splitter.assign(partition.BlockBegin(block), partition.BlockEnd(block));
+            
+            // Mark every state with a label-arc into the splitter, then split what they touched
+            for(Index dest : splitter) {
+                for(const Index *src = inverse.SourcesBegin(dest, label); src != inverse.SourcesEnd(dest, label); ++src) {
+                    partition.Mark(*src);
+                }
+            }
+            partition.SplitMarked();
+        }
+        
+        // Renumber the blocks in BFS order, the sink's block becomes INVALID_STATE
+        result.initialState = BuildQuotient(partition, states, target, result.automaton);
+        result.mergedStates = reachable - result.automaton.GetNumStates();
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> Minimize(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        MinimizeResult<ALPHABET_SIZE, StateIdType> minimized = Minimize(*language.GetAutomaton(), language.GetInitialState());
+        
+        std::shared_ptr<const DAutomaton<ALPHABET_SIZE, StateIdType> > automaton(new DAutomaton<ALPHABET_SIZE, StateIdType>(std::move(minimized.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>(automaton, minimized.initialState);
+    }
+}
\ No newline at end of file
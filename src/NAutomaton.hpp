@@ -2,19 +2,28 @@
 
 #include <stdexcept>
 #include <limits>
+#include <vector>
+#include <tuple>
+#include <type_traits>
 
 #include <boost/container/flat_map.hpp>
 #include <boost/dynamic_bitset.hpp>
 
 namespace FACore {
-    template<unsigned int AlphabetSize>
+    template<unsigned int AlphabetSize, typename StateIdType>
+    class NAutomatonBuilder;
+    
+    // StateIdType must be an unsigned integer type, its maximum value is reserved for INVALID_STATE.
+    template<unsigned int AlphabetSize, typename StateIdType = unsigned int>
     class NAutomaton {
         public:
-            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
-            constexpr static unsigned int INVALID_STATE = std::numeric_limits<unsigned int>::max();
+            static_assert(std::is_integral<StateIdType>::value && std::is_unsigned<StateIdType>::value, "StateIdType must be an unsigned integer type");
             
             // A StateId is really just an index into a vector
-            typedef unsigned int StateId;
+            typedef StateIdType StateId;
+            
+            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
+            constexpr static StateId INVALID_STATE = std::numeric_limits<StateId>::max();
             
             // Label values must be between 0 and ALPHABET_SIZE
             typedef unsigned int Label;
@@ -22,7 +31,9 @@ namespace FACore {
             // <(src,label),dest>
             typedef std::pair<std::tuple<StateId,Label>,StateId> TransitionMapEntry;
             
-            typedef boost::container::flat_multimap<std::tuple<StateId,Label>,StateId>::const_iterator TransitionIterator;
+            typedef boost::container::flat_multimap<std::tuple<StateId,Label>,StateId> TransitionMap;
+            
+            typedef typename TransitionMap::const_iterator TransitionIterator;
             
             class ArcRange {
                 public:
@@ -40,13 +51,36 @@ namespace FACore {
                     TransitionIterator mIterEnd;
             };
             
+            // <src,dest> pairs of arcs that consume no label
+            typedef boost::container::flat_multimap<StateId,StateId> EpsilonMap;
+            
+            typedef typename EpsilonMap::const_iterator EpsilonIterator;
+            
+            class EpsilonArcRange {
+                public:
+                    EpsilonArcRange (const std::pair<EpsilonIterator,EpsilonIterator> &range)
+                    {
+                        mIterStart = range.first;
+                        mIterEnd = range.second;
+                    }
+                    
+                    EpsilonIterator begin() const { return mIterStart; }
+                    EpsilonIterator end() const { return mIterEnd; }
+                
+                private:
+                    EpsilonIterator mIterStart;
+                    EpsilonIterator mIterEnd;
+            };
+            
             StateId AddState(bool isFinal) {
-                if(mFinalStates.size() == INVALID_STATE) {
+                if(mFinalStates.size() >= INVALID_STATE) {
                     // WARNING this is outside of testing code coverage
                     throw std::out_of_range("Invalid label"); 
                 }
                 StateId result = mFinalStates.size();
                 mFinalStates.push_back(isFinal);
+                mOffsets.clear();
+                mGeneration++;
                 return result;
             }
             
@@ -62,6 +96,39 @@ namespace FACore {
                 }
                 TransitionMapEntry newTransition {std::make_tuple(src,label),dest};
                 mTransitions.insert(newTransition);
+                mOffsets.clear();
+                mGeneration++;
+            }
+            
+            // An arc from src to dest that consumes no label. Consumers close state sets
+            // over these arcs with an EpsilonClosure, computed once per automaton.
+            void AddEpsilonArc(StateId src, StateId dest) {
+                if(!IsValidState(src)) {
+                    throw std::out_of_range("Invalid source state.");
+                }
+                if(!IsValidState(dest)) {
+                    throw std::out_of_range("Invalid dest state");
+                }
+                mEpsilonTransitions.insert(std::make_pair(src, dest));
+                mGeneration++;
+            }
+            
+            // Builds a compressed sparse row index over the sorted transitions, so that
+            // GetNext becomes two array reads instead of a binary search.
+            // Any later AddState or AddArc drops the index again.
+            void Freeze() {
+                const StateId numStates = GetNumStates();
+                mOffsets.assign(static_cast<std::size_t>(numStates) * ALPHABET_SIZE + 1, 0);
+                for(auto &arc : mTransitions) {
+                    mOffsets[static_cast<std::size_t>(std::get<0>(arc.first)) * ALPHABET_SIZE + std::get<1>(arc.first) + 1]++;
+                }
+                for(std::size_t i = 1; i < mOffsets.size(); i++) {
+                    mOffsets[i] += mOffsets[i - 1];
+                }
+            }
+            
+            bool IsFrozen() const {
+                return !mOffsets.empty();
             }
             
             bool IsValidState(StateId state) const {
@@ -72,23 +139,66 @@ namespace FACore {
                 return label < ALPHABET_SIZE;
             }
             
+            StateId GetNumStates() const {
+                return mFinalStates.size();
+            }
+            
             ArcRange GetNext(StateId src, Label label) const {
+                if(IsFrozen()) {
+                    if(!IsValidState(src) || !IsValidLabel(label)) {
+                        return ArcRange( std::make_pair(mTransitions.end(), mTransitions.end()) );
+                    }
+                    std::size_t index = static_cast<std::size_t>(src) * ALPHABET_SIZE + label;
+                    return ArcRange( std::make_pair(mTransitions.begin() + mOffsets[index], mTransitions.begin() + mOffsets[index + 1]) );
+                }
                 std::tuple<StateId,Label> key(src,label);
                 return ArcRange( mTransitions.equal_range(key) );
             }
             
+            EpsilonArcRange GetEpsilonNext(StateId src) const {
+                return EpsilonArcRange( mEpsilonTransitions.equal_range(src) );
+            }
+            
+            bool HasEpsilonArcs() const {
+                return !mEpsilonTransitions.empty();
+            }
+            
+            std::size_t GetNumEpsilonArcs() const {
+                return mEpsilonTransitions.size();
+            }
+            
             bool IsFinal(StateId state) const {
                 if(!IsValidState(state)) {
                     return false;
                 }
                 return mFinalStates[state];
             }
+            
+            // Changes whenever a state or arc is added, Freeze leaves it alone since the arcs stay the same
+            std::size_t GetGeneration() const {
+                return mGeneration;
+            }
         
         private:
-            boost::container::flat_multimap<std::tuple<StateId,Label>,StateId> mTransitions;
+            friend class NAutomatonBuilder<AlphabetSize, StateIdType>;
+            
+            TransitionMap mTransitions;
+            EpsilonMap mEpsilonTransitions;
             boost::dynamic_bitset<> mFinalStates;
+            
+            // CSR index into mTransitions, indexed by src * ALPHABET_SIZE + label. Empty unless frozen.
+            std::vector<std::size_t> mOffsets;
+            
+            std::size_t mGeneration = 0;
     };
     
+    // Out of class definitions, needed when these are bound to a reference
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr unsigned int NAutomaton<AlphabetSize, StateIdType>::ALPHABET_SIZE;
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr typename NAutomaton<AlphabetSize, StateIdType>::StateId NAutomaton<AlphabetSize, StateIdType>::INVALID_STATE;
+    
     typedef NAutomaton<2> NFA;
     
     
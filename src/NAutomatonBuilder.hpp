@@ -0,0 +1,175 @@
+#pragma once
+
+#include "NAutomaton.hpp"
+
+#include <stdexcept>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // Collects states and arcs in any order and produces a frozen NAutomaton.
+    // AddArc is an amortized O(1) append, Freeze sorts the arcs with a counting sort
+    // over (src,label), so building an automaton with m arcs takes O(m + n * ALPHABET_SIZE).
+    // Reserve, AddStates and AddArcs cover automata whose size is known up front.
+    template<unsigned int AlphabetSize, typename StateIdType = unsigned int>
+    class NAutomatonBuilder {
+        public:
+            typedef NAutomaton<AlphabetSize, StateIdType> Machine;
+            
+            typedef typename Machine::StateId StateId;
+            typedef typename Machine::Label Label;
+            
+            constexpr static unsigned int ALPHABET_SIZE = AlphabetSize;
+            
+            struct Arc {
+                StateId src;
+                Label label;
+                StateId dest;
+            };
+            
+            // Sizes the buffers once for an automaton of known size
+            void Reserve(StateId numStates, std::size_t numArcs) {
+                mFinalStates.reserve(numStates);
+                mArcs.reserve(numArcs);
+            }
+            
+            StateId AddState(bool isFinal) {
+                return AddStates(1, isFinal);
+            }
+            
+            // Adds count states and returns the first one, the rest follow it
+            StateId AddStates(StateId count, bool isFinal) {
+                if(count > Machine::INVALID_STATE - mFinalStates.size()) {
+                    // WARNING this is outside of testing code coverage
+                    throw std::out_of_range("Too many states");
+                }
+                StateId result = mFinalStates.size();
+                mFinalStates.resize(mFinalStates.size() + count, isFinal);
+                return result;
+            }
+            
+            void AddArc(StateId src, Label label, StateId dest) {
+                if(ALPHABET_SIZE <= label) {
+                    throw std::out_of_range("Invalid label");
+                }
+                if(mFinalStates.size() <= src) {
+                    throw std::out_of_range("Invalid source state.");
+                }
+                if(mFinalStates.size() <= dest) {
+                    throw std::out_of_range("Invalid dest state");
+                }
+                mArcs.push_back(Arc {src, label, dest});
+            }
+            
+            // Appends a batch of arcs with a single validation pass, either all of them or none
+            void AddArcs(const Arc *arcs, std::size_t count) {
+                if(count == 0) {
+                    return;
+                }
+                StateId maxSrc = 0;
+                StateId maxDest = 0;
+                Label maxLabel = 0;
+                for(std::size_t i = 0; i < count; i++) {
+                    maxSrc = std::max(maxSrc, arcs[i].src);
+                    maxDest = std::max(maxDest, arcs[i].dest);
+                    maxLabel = std::max(maxLabel, arcs[i].label);
+                }
+                if(ALPHABET_SIZE <= maxLabel) {
+                    throw std::out_of_range("Invalid label");
+                }
+                if(mFinalStates.size() <= maxSrc) {
+                    throw std::out_of_range("Invalid source state.");
+                }
+                if(mFinalStates.size() <= maxDest) {
+                    throw std::out_of_range("Invalid dest state");
+                }
+                mArcs.insert(mArcs.end(), arcs, arcs + count);
+            }
+            
+            void AddArcs(const std::vector<Arc> &arcs) {
+                AddArcs(arcs.data(), arcs.size());
+            }
+            
+            void AddEpsilonArc(StateId src, StateId dest) {
+                if(mFinalStates.size() <= src) {
+                    throw std::out_of_range("Invalid source state.");
+                }
+                if(mFinalStates.size() <= dest) {
+                    throw std::out_of_range("Invalid dest state");
+                }
+                mEpsilonArcs.emplace_back(src, dest);
+            }
+            
+            StateId GetNumStates() const {
+                return mFinalStates.size();
+            }
+            
+            std::size_t GetNumArcs() const {
+                return mArcs.size();
+            }
+            
+            std::size_t GetNumEpsilonArcs() const {
+                return mEpsilonArcs.size();
+            }
+            
+            // Hands the collected states and arcs to a new frozen NAutomaton and resets the builder.
+            // Parallel arcs keep the order in which they were added, as with NAutomaton::AddArc.
+            Machine Freeze() {
+                const std::size_t numKeys = static_cast<std::size_t>(mFinalStates.size()) * ALPHABET_SIZE;
+                
+                std::vector<std::size_t> offsets(numKeys + 1, 0);
+                for(const Arc &arc : mArcs) {
+                    offsets[Key(arc) + 1]++;
+                }
+                for(std::size_t i = 1; i < offsets.size(); i++) {
+                    offsets[i] += offsets[i - 1];
+                }
+                
+                typename Machine::TransitionMap::sequence_type sorted(mArcs.size());
+                {
+                    std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+                    for(const Arc &arc : mArcs) {
+                        sorted[fill[Key(arc)]++] = typename Machine::TransitionMapEntry(std::make_tuple(arc.src, arc.label), arc.dest);
+                    }
+                }
+                
+                typename Machine::EpsilonMap::sequence_type epsilonArcs(mEpsilonArcs.begin(), mEpsilonArcs.end());
+                typedef typename Machine::EpsilonMap::value_type EpsilonEntry;
+                std::stable_sort(epsilonArcs.begin(), epsilonArcs.end(), [](const EpsilonEntry &left, const EpsilonEntry &right) {
+                    return left.first < right.first;
+                });
+                
+                Machine machine;
+                machine.mTransitions.adopt_sequence(boost::container::ordered_range, boost::move(sorted));
+                machine.mEpsilonTransitions.adopt_sequence(boost::container::ordered_range, boost::move(epsilonArcs));
+                machine.mFinalStates.swap(mFinalStates);
+                machine.mOffsets.swap(offsets);
+                
+                mFinalStates.clear();
+                mArcs.clear();
+                mEpsilonArcs.clear();
+                return machine;
+            }
+        
+        private:
+            typedef std::pair<StateId, StateId> EpsilonArc;
+            
+            static std::size_t Key(const Arc &arc) {
+                return static_cast<std::size_t>(arc.src) * ALPHABET_SIZE + arc.label;
+            }
+            
+            std::vector<Arc> mArcs;
+            std::vector<EpsilonArc> mEpsilonArcs;
+            boost::dynamic_bitset<> mFinalStates;
+    };
+    
+    template<unsigned int AlphabetSize, typename StateIdType>
+    constexpr unsigned int NAutomatonBuilder<AlphabetSize, StateIdType>::ALPHABET_SIZE;
+    
+    typedef NAutomatonBuilder<2> NFABuilder;
+}
\ No newline at end of file
@@ -1,31 +1,69 @@
 #pragma once
 
 #include "utils/DigitIterator.hpp"
+#include "utils/LazyDFACache.hpp"
+#include "utils/EpsilonClosure.hpp"
+#include "utils/Instrumentation.hpp"
+#include "utils/DecidedStates.hpp"
+#include "utils/Scanner.hpp"
 #include "NAutomaton.hpp"
 
 #include <memory>
 #include <set>
+#include <vector>
+#include <limits>
+
+#include <boost/dynamic_bitset.hpp>
 
 namespace FACore {
-    template<unsigned int ALPHABET_SIZE>
-    class NRegularLanguage {
+    
+    enum class SimulationMode {
+        // Active states are kept in a std::set, no precomputation
+        StateSet,
+        
+        // Active states are kept in a bitset and each step ORs precomputed successor masks.
+        // The masks take ALPHABET_SIZE * n * n bits, intended for NFAs of up to a few thousand states.
+        BitParallel,
+        
+        // Subsets of states are determinized on demand and memoized in a LazyDFACache,
+        // which is flushed whenever it would grow past its memory budget.
+        LazyDFA
+    };
+    
+    // Instrumentation is a policy from utils/Instrumentation.hpp, the default records nothing
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int, class Instrumentation = NoInstrumentation>
+    class NRegularLanguage : private Instrumentation {
         
         public:
-            typedef NAutomaton<ALPHABET_SIZE> Machine;
+            typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
             
             typedef typename Machine::Label Character;
             typedef typename Machine::StateId StateId;
             
             constexpr static unsigned int AlphabetSize = ALPHABET_SIZE;
+            
+            // Memory budget of the lazy DFA cache, in bytes
+            constexpr static std::size_t DEFAULT_CACHE_BUDGET = 1 << 20;
+            
+            typedef LazyDFACache<Machine> Cache;
+            
+            typedef EpsilonClosure<Machine> Closure;
         
         private:
             typedef DigitIterator<ALPHABET_SIZE, Character> Digitizer;
         
         public:
-            NRegularLanguage(std::shared_ptr<const Machine> automaton, std::set<StateId> initialStates) : mAutomaton(automaton), mInitialStates(initialStates)
+            // Epsilon closures are computed here, every mode then steps from closed set to closed set.
+            // Dead and accepting states and the tables of the mode are left to the first query, so
+            // languages that are never queried cost nothing: dead states are dropped from the active
+            // states and a query ends as soon as an accepting state is active.
+            // Everything is computed again by the first query after the automaton has changed.
+            NRegularLanguage(std::shared_ptr<const Machine> automaton, std::set<StateId> initialStates, SimulationMode mode = SimulationMode::StateSet, std::size_t cacheBudget = DEFAULT_CACHE_BUDGET) :
+                mAutomaton(automaton), mInitialStates(initialStates), mMode(mode), mCacheBudget(cacheBudget),
+                mClosure(new Closure(*automaton)), mClosureGeneration(automaton->GetGeneration()), mPreparedGeneration(NOT_PREPARED), mScannerGeneration(NOT_PREPARED)
             {}
             
-            NRegularLanguage(Machine* automaton, StateId initialState) : NRegularLanguage(std::shared_ptr<const Machine>(automaton), {initialState})
+            NRegularLanguage(Machine* automaton, StateId initialState, SimulationMode mode = SimulationMode::StateSet, std::size_t cacheBudget = DEFAULT_CACHE_BUDGET) : NRegularLanguage(std::shared_ptr<const Machine>(automaton), {initialState}, mode, cacheBudget)
             {}
             
             // These objects are lightweight and dynamic allocating should be avoided.
@@ -33,23 +71,41 @@ namespace FACore {
             
             template<typename IterType>
             bool contains(IterType begin, IterType end) {
-                std::set<StateId> currentStates = mInitialStates;
+                Prepare();
+                if(mMode == SimulationMode::BitParallel) {
+                    return containsBitParallel(begin, end);
+                }
+                if(mMode == SimulationMode::LazyDFA) {
+                    return containsLazyDFA(begin, end);
+                }
+                
+                std::set<StateId> currentStates = mStartStates;
                 std::set<StateId> nextStates;
+                bool accepting = HasAcceptingState(currentStates);
                 
-                for(auto iter = begin; iter != end && currentStates.size() > 0; ++iter) {
+                std::size_t consumed = 0;
+                auto iter = begin;
+                for(; iter != end && currentStates.size() > 0 && !accepting; ++iter, ++consumed) {
+                    if(Instrumentation::ENABLED) {
+                        Instrumentation::RecordActiveStates(currentStates.size());
+                    }
                     Character c = *iter;
                     for(StateId src : currentStates) {
                         for(auto &arc : mAutomaton->GetNext(src, c)) {
-                            nextStates.insert(ArcDestination(arc));
+                            accepting = InsertLive(nextStates, ArcDestination(arc)) || accepting;
                         }
                     }
                     currentStates.swap(nextStates);
                     nextStates.clear();
                 }
+                if(Instrumentation::ENABLED) {
+                    Instrumentation::RecordActiveStates(currentStates.size());
+                    Instrumentation::RecordQuery(consumed, iter != end);
+                }
                 
                 for(StateId state : currentStates) {
                     if(mAutomaton->IsFinal(state)) {
-                        return true;
+                        return AllLabelsValid<ALPHABET_SIZE>(iter, end);
                     }
                 }
                 return false;
@@ -58,9 +114,250 @@ namespace FACore {
             virtual bool contains(unsigned int number) {
                 return contains(Digitizer(number), Digitizer::end());
             }
+            
+            // Any unsigned builtin, unsigned __int128 or cpp_int, its digits read in the given order
+            template<DigitOrder ORDER = DigitOrder::LeastSignificantFirst, typename NumberType>
+            bool containsNumber(const NumberType &number) {
+                typedef typename DigitIteratorFor<ALPHABET_SIZE, ORDER, Character, NumberType>::type Digits;
+                return contains(Digits(number), Digits::end());
+            }
+            
+            std::shared_ptr<const Machine> GetAutomaton() const {
+                return mAutomaton;
+            }
+            
+            const std::set<StateId>& GetInitialStates() const {
+                return mInitialStates;
+            }
+            
+            SimulationMode GetSimulationMode() const {
+                return mMode;
+            }
+            
+            // Calls callback(offset) for every offset in [0, end - begin] at which some substring
+            // of the input in the language ends, in one pass and whatever the simulation mode.
+            // The scanner is built on first use, with the cache budget of the language.
+            template<typename IterType, class Callback>
+            void scan(IterType begin, IterType end, Callback callback) {
+                if(!mScanner || mScannerGeneration != mAutomaton->GetGeneration()) {
+                    mScanner.reset(new Scanner<ALPHABET_SIZE, StateIdType>(*mAutomaton, mInitialStates, mCacheBudget));
+                    mScannerGeneration = mAutomaton->GetGeneration();
+                }
+                mScanner->scan(begin, end, callback);
+            }
+            
+            // Only available in SimulationMode::LazyDFA once a query has run, nullptr otherwise
+            const Cache* GetCache() const {
+                return mCache.get();
+            }
+            
+            // Memory budget the lazy DFA cache and the scanner are built with, whatever the mode
+            std::size_t GetCacheBudget() const {
+                return mCacheBudget;
+            }
+            
+            // Shared with the lazy DFA cache and with any NMatcher built from this language.
+            // Once the automaton has changed, fresh closures are returned until the next query stores them.
+            std::shared_ptr<const Closure> GetEpsilonClosure() const {
+                if(mClosureGeneration != mAutomaton->GetGeneration()) {
+                    return std::make_shared<const Closure>(*mAutomaton);
+                }
+                return mClosure;
+            }
+            
+            const Instrumentation& GetInstrumentation() const {
+                return *this;
+            }
+            
+            Instrumentation& GetInstrumentation() {
+                return *this;
+            }
         
         private:
+            typedef boost::dynamic_bitset<> StateMask;
+            
+            constexpr static std::size_t NOT_PREPARED = std::numeric_limits<std::size_t>::max();
+            
+            // Brings the closures, the decided states and the tables of the mode up to date with the automaton
+            void Prepare() {
+                const std::size_t generation = mAutomaton->GetGeneration();
+                if(mPreparedGeneration == generation) {
+                    return;
+                }
+                if(mClosureGeneration != generation) {
+                    mClosure = std::make_shared<const Closure>(*mAutomaton);
+                    mClosureGeneration = generation;
+                }
+                mDecided = FindDecidedStates(*mAutomaton, *mClosure);
+                if(mMode == SimulationMode::BitParallel) {
+                    BuildSuccessorMasks();
+                } else if(mMode == SimulationMode::LazyDFA) {
+                    mCache.reset(new Cache(*mAutomaton, mClosure, InitialMask(), mCacheBudget, mDecided));
+                } else {
+                    mStartStates.clear();
+                    for(StateId state : mInitialStates) {
+                        if(mAutomaton->IsValidState(state)) {
+                            InsertLive(mStartStates, state);
+                        }
+                    }
+                }
+                mPreparedGeneration = generation;
+            }
+            
+            // The active sets are members so that a query does no heap allocation
+            template<typename IterType>
+            bool containsBitParallel(IterType begin, IterType end) {
+                const StateId numStates = mFinalMask.size();
+                mCurrentMask = mInitialMask;
+                
+                std::size_t consumed = 0;
+                auto iter = begin;
+                for(; iter != end && mCurrentMask.any() && !mCurrentMask.intersects(mDecided.accepting); ++iter, ++consumed) {
+                    if(Instrumentation::ENABLED) {
+                        Instrumentation::RecordActiveStates(mCurrentMask.count());
+                    }
+                    Character c = *iter;
+                    if(!mAutomaton->IsValidLabel(c)) {
+                        if(Instrumentation::ENABLED) {
+                            Instrumentation::RecordQuery(consumed, true);
+                        }
+                        return false;
+                    }
+                    const StateMask *masks = &mSuccessorMasks[c * numStates];
+                    mNextMask.reset();
+                    for(auto src = mCurrentMask.find_first(); src != StateMask::npos; src = mCurrentMask.find_next(src)) {
+                        mNextMask |= masks[src];
+                    }
+                    mCurrentMask.swap(mNextMask);
+                }
+                if(Instrumentation::ENABLED) {
+                    Instrumentation::RecordActiveStates(mCurrentMask.count());
+                    Instrumentation::RecordQuery(consumed, iter != end);
+                }
+                
+                return mCurrentMask.intersects(mFinalMask) && AllLabelsValid<ALPHABET_SIZE>(iter, end);
+            }
+            
+            template<typename IterType>
+            bool containsLazyDFA(IterType begin, IterType end) {
+                const std::size_t misses = mCache->GetNumMisses();
+                typename Cache::StateId currentState = mCache->GetInitialState();
+                std::size_t consumed = 0;
+                auto iter = begin;
+                for(; iter != end && currentState != Cache::DEAD_STATE && !mCache->IsAccepting(currentState); ++iter, ++consumed) {
+                    if(Instrumentation::ENABLED) {
+                        Instrumentation::RecordActiveStates(mCache->GetSubset(currentState).count());
+                    }
+                    Character c = *iter;
+                    if(!mAutomaton->IsValidLabel(c)) {
+                        RecordLazyDFAQuery(consumed, true, misses);
+                        return false;
+                    }
+                    currentState = mCache->GetNext(currentState, c);
+                }
+                RecordLazyDFAQuery(consumed, iter != end, misses);
+                return mCache->IsFinal(currentState) && AllLabelsValid<ALPHABET_SIZE>(iter, end);
+            }
+            
+            // misses is the cache's miss count before the query, every consumed character was one lookup
+            void RecordLazyDFAQuery(std::size_t consumed, bool stoppedEarly, std::size_t misses) {
+                if(Instrumentation::ENABLED) {
+                    const std::size_t newMisses = mCache->GetNumMisses() - misses;
+                    Instrumentation::RecordCacheLookups(consumed - newMisses, newMisses);
+                    Instrumentation::RecordQuery(consumed, stoppedEarly);
+                }
+            }
+            
+            // Adds the live states of the closure of state, returns whether one of them is accepting
+            bool InsertLive(std::set<StateId> &states, StateId state) const {
+                bool accepting = false;
+                for(StateId member : mClosure->GetClosure(state)) {
+                    if(!mDecided.dead[member]) {
+                        states.insert(member);
+                        accepting = accepting || mDecided.accepting[member];
+                    }
+                }
+                return accepting;
+            }
+            
+            bool HasAcceptingState(const std::set<StateId> &states) const {
+                for(StateId state : states) {
+                    if(mDecided.accepting[state]) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            
+            // Already closed over epsilon arcs
+            StateMask InitialMask() const {
+                StateMask mask(mAutomaton->GetNumStates());
+                for(StateId state : mInitialStates) {
+                    if(mAutomaton->IsValidState(state)) {
+                        mClosure->Insert(mask, state);
+                    }
+                }
+                return mask;
+            }
+            
+            void BuildSuccessorMasks() {
+                const StateId numStates = mAutomaton->GetNumStates();
+                
+                mSuccessorMasks.assign(ALPHABET_SIZE * numStates, StateMask(numStates));
+                for(Character c = 0; c < ALPHABET_SIZE; c++) {
+                    for(StateId src = 0; src < numStates; src++) {
+                        for(auto &arc : mAutomaton->GetNext(src, c)) {
+                            mClosure->Insert(mSuccessorMasks[c * numStates + src], ArcDestination(arc));
+                        }
+                        mSuccessorMasks[c * numStates + src] -= mDecided.dead;
+                    }
+                }
+                
+                mFinalMask.resize(numStates);
+                for(StateId state = 0; state < numStates; state++) {
+                    mFinalMask[state] = mAutomaton->IsFinal(state);
+                }
+                
+                mInitialMask = InitialMask() - mDecided.dead;
+                mCurrentMask.resize(numStates);
+                mNextMask.resize(numStates);
+            }
+            
             std::shared_ptr<const Machine> mAutomaton;
             std::set<StateId> mInitialStates;
+            SimulationMode mMode;
+            std::size_t mCacheBudget;
+            
+            // Shared with the lazy DFA cache, which outlives moves of this object
+            std::shared_ptr<const Closure> mClosure;
+            std::size_t mClosureGeneration;
+            
+            // Generation of the automaton that everything below was computed for
+            std::size_t mPreparedGeneration;
+            
+            DecidedStates mDecided;
+            
+            // Only populated in SimulationMode::StateSet, the live states of the closure of the initial states
+            std::set<StateId> mStartStates;
+            
+            // Only populated in SimulationMode::BitParallel, indexed by label * numStates + state
+            std::vector<StateMask> mSuccessorMasks;
+            StateMask mInitialMask;
+            StateMask mFinalMask;
+            StateMask mCurrentMask;
+            StateMask mNextMask;
+            
+            // Only populated in SimulationMode::LazyDFA
+            std::unique_ptr<Cache> mCache;
+            
+            // Only populated once scan is called, rebuilt once the automaton has changed
+            std::unique_ptr<Scanner<ALPHABET_SIZE, StateIdType> > mScanner;
+            std::size_t mScannerGeneration;
     };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    constexpr std::size_t NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>::DEFAULT_CACHE_BUDGET;
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    constexpr std::size_t NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>::NOT_PREPARED;
 }
\ No newline at end of file
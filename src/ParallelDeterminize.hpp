@@ -0,0 +1,92 @@
+#pragma once
+
+#include "NAutomaton.hpp"
+#include "DAutomaton.hpp"
+#include "NRegularLanguage.hpp"
+#include "DRegularLanguage.hpp"
+#include "Determinize.hpp"
+#include "utils/SubsetConstruction.hpp"
+#include "utils/ParallelFor.hpp"
+
+#include <set>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace FACore {
+    
+    // Bytes of successor subsets ParallelDeterminize keeps at once, it sizes its batches to fit
+    constexpr std::size_t PARALLEL_DETERMINIZE_BATCH_BYTES = 64 << 20;
+    
+    // Subset construction with the successors of many subsets computed at once. The
+    // subsets are expanded in batches of consecutive ids; within a batch, threads
+    // build the successor subsets and look them up among the subsets interned so far,
+    // which nothing modifies meanwhile. Successors that are new are then interned on
+    // the calling thread, in (state, label) order. This is the order of Determinize,
+    // so the result is identical to it for every thread count. Interning is the only
+    // serial step, and it only hashes subsets that were not seen before.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    DeterminizeResult<ALPHABET_SIZE, StateIdType> ParallelDeterminize(const NAutomaton<ALPHABET_SIZE, StateIdType> &nfa, const std::set<typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId> &initialStates, unsigned int numThreads = 0) {
+        typedef SubsetStates<ALPHABET_SIZE, StateIdType> States;
+        typedef typename States::DMachine DMachine;
+        typedef typename States::DStateId DStateId;
+        typedef typename States::Label Label;
+        typedef typename States::Subset Subset;
+        
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> result;
+        States states(nfa, result.automaton);
+        
+        Subset initial = states.GetInitialSubset(initialStates);
+        if(initial.none()) {
+            result.initialState = DMachine::INVALID_STATE;
+            return result;
+        }
+        result.initialState = states.Intern(initial);
+        
+        // Slots for every (state, label) of a batch, reused from batch to batch
+        const std::size_t subsetBytes = std::max<std::size_t>(initial.num_blocks() * sizeof(typename Subset::block_type), 1);
+        const std::size_t batchSize = std::max<std::size_t>(1, std::min<std::size_t>(4096, PARALLEL_DETERMINIZE_BATCH_BYTES / (subsetBytes * ALPHABET_SIZE)));
+        std::vector<Subset> successors(batchSize * ALPHABET_SIZE, Subset(nfa.GetNumStates()));
+        std::vector<DStateId> known(batchSize * ALPHABET_SIZE);
+        
+        std::size_t batchEnd;
+        for(std::size_t batchStart = 0; batchStart < states.GetNumSubsets(); batchStart = batchEnd) {
+            batchEnd = std::min(states.GetNumSubsets(), batchStart + batchSize);
+            
+            ParallelFor(batchEnd - batchStart, numThreads, 16, [&](std::size_t begin, std::size_t end, unsigned int) {
+                for(std::size_t offset = begin; offset < end; offset++) {
+                    const Subset &subset = states.GetSubset(batchStart + offset);
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        Subset &next = successors[offset * ALPHABET_SIZE + label];
+                        states.GetSuccessors(subset, label, next);
+                        known[offset * ALPHABET_SIZE + label] = next.any() ? states.Find(next) : DMachine::INVALID_STATE;
+                    }
+                }
+            });
+            
+            for(std::size_t offset = 0; offset < batchEnd - batchStart; offset++) {
+                for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                    const Subset &next = successors[offset * ALPHABET_SIZE + label];
+                    if(next.none()) {
+                        continue;
+                    }
+                    DStateId id = known[offset * ALPHABET_SIZE + label];
+                    if(id == DMachine::INVALID_STATE) {
+                        id = states.Intern(next);
+                    }
+                    result.automaton.SetArc(batchStart + offset, label, id);
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> ParallelDeterminize(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language, unsigned int numThreads = 0) {
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> determinized = ParallelDeterminize(*language.GetAutomaton(), language.GetInitialStates(), numThreads);
+        
+        std::shared_ptr<const DAutomaton<ALPHABET_SIZE, StateIdType> > automaton(new DAutomaton<ALPHABET_SIZE, StateIdType>(std::move(determinized.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>(automaton, determinized.initialState);
+    }
+}
\ No newline at end of file
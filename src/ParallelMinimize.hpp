@@ -0,0 +1,117 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "Minimize.hpp"
+#include "utils/ParallelFor.hpp"
+#include "utils/PartitionRefinement.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+namespace FACore {
+    
+    // Hopcroft partition refinement, O(n*k*log n) like Minimize, run in rounds. Each round
+    // takes every pending (block, label) splitter at once and gathers the predecessors of all
+    // of them in parallel, which is where the random reads into the inverse transitions are.
+    // The gathered sources then mark and split the blocks serially, most recently queued
+    // splitter first. A splitter is read when its round starts, so a block split
+    // later in the same round is still refined by its earlier contents, that is by the union
+    // of its halves, and only the smaller half has to be queued again. Rounds with few
+    // splitters run on the calling thread alone. The input is restricted and completed with
+    // a sink exactly like Minimize does, and since the coarsest partition is unique the final
+    // BFS renumbering gives a result identical to Minimize for every thread count.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    MinimizeResult<ALPHABET_SIZE, StateIdType> ParallelMinimize(const DAutomaton<ALPHABET_SIZE, StateIdType> &dfa, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState, unsigned int numThreads = 0) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::Label Label;
+        
+        const std::size_t CHUNK_SIZE = 1024;
+        
+        // Splitters per chunk when gathering, small rounds stay on one thread
+        const std::size_t SPLITTER_CHUNK_SIZE = 64;
+        
+        MinimizeResult<ALPHABET_SIZE, StateIdType> result;
+        result.initialState = Machine::INVALID_STATE;
+        result.mergedStates = 0;
+        result.unreachableStates = dfa.GetNumStates();
+        
+        if(!dfa.IsValidState(initialState)) {
+            return result;
+        }
+        
+        const CompletedReachableStates<ALPHABET_SIZE, StateIdType> states(dfa, initialState);
+        typedef typename CompletedReachableStates<ALPHABET_SIZE, StateIdType>::Index Index;
+        const Index reachable = states.GetNumReachable();
+        const Index numStates = states.GetNumStates();
+        result.unreachableStates = dfa.GetNumStates() - reachable;
+        
+        // Dense transition table, the sink loops on every label
+        std::vector<Index> targets(static_cast<std::size_t>(numStates) * ALPHABET_SIZE, states.GetSink());
+        ParallelFor(reachable, numThreads, CHUNK_SIZE, [&](std::size_t begin, std::size_t end, unsigned int) {
+            for(std::size_t state = begin; state < end; state++) {
+                for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                    targets[state * ALPHABET_SIZE + label] = states.GetNext(state, label);
+                }
+            }
+        });
+        auto target = [&](Index state, Label label) -> Index {
+            return targets[static_cast<std::size_t>(state) * ALPHABET_SIZE + label];
+        };
+        const InverseTransitions<ALPHABET_SIZE, Index> inverse(numStates, target);
+        HopcroftPartition<ALPHABET_SIZE, Index> partition(numStates, [&](Index state) { return states.IsFinal(state); });
+        
+        // Sources of the round's splitters, splitter i owns [sourceOffsets[i], sourceOffsets[i + 1])
+        std::vector<typename HopcroftPartition<ALPHABET_SIZE, Index>::Splitter> round;
+        std::vector<std::size_t> sourceOffsets;
+        std::vector<Index> sources;
+        while(partition.HasSplitters()) {
+            partition.TakeSplitters(round);
+            
+            sourceOffsets.assign(round.size() + 1, 0);
+            ParallelFor(round.size(), numThreads, SPLITTER_CHUNK_SIZE, [&](std::size_t begin, std::size_t end, unsigned int) {
+                for(std::size_t i = begin; i < end; i++) {
+                    std::size_t count = 0;
+                    for(const Index *dest = partition.BlockBegin(round[i].first); dest != partition.BlockEnd(round[i].first); ++dest) {
+                        count += inverse.SourcesEnd(*dest, round[i].second) - inverse.SourcesBegin(*dest, round[i].second);
+                    }
+                    sourceOffsets[i + 1] = count;
+                }
+            });
+            for(std::size_t i = 1; i < sourceOffsets.size(); i++) {
+                sourceOffsets[i] += sourceOffsets[i - 1];
+            }
+            sources.resize(sourceOffsets.back());
+            ParallelFor(round.size(), numThreads, SPLITTER_CHUNK_SIZE, [&](std::size_t begin, std::size_t end, unsigned int) {
+                for(std::size_t i = begin; i < end; i++) {
+                    Index *out = sources.data() + sourceOffsets[i];
+                    for(const Index *dest = partition.BlockBegin(round[i].first); dest != partition.BlockEnd(round[i].first); ++dest) {
+                        out = std::copy(inverse.SourcesBegin(*dest, round[i].second), inverse.SourcesEnd(*dest, round[i].second), out);
+                    }
+                }
+            });
+            
+            // Each gathered source has a single arc with the splitter's label
+            for(std::size_t i = 0; i < round.size(); i++) {
+                for(std::size_t j = sourceOffsets[i]; j < sourceOffsets[i + 1]; j++) {
+                    partition.Mark(sources[j]);
+                }
+                partition.SplitMarked();
+            }
+        }
+        
+        // Renumber the blocks in BFS order, the sink's block becomes INVALID_STATE
+        result.initialState = BuildQuotient(partition, states, target, result.automaton);
+        result.mergedStates = reachable - result.automaton.GetNumStates();
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> ParallelMinimize(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language, unsigned int numThreads = 0) {
+        MinimizeResult<ALPHABET_SIZE, StateIdType> minimized = ParallelMinimize(*language.GetAutomaton(), language.GetInitialState(), numThreads);
+        
+        std::shared_ptr<const DAutomaton<ALPHABET_SIZE, StateIdType> > automaton(new DAutomaton<ALPHABET_SIZE, StateIdType>(std::move(minimized.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>(automaton, minimized.initialState);
+    }
+}
\ No newline at end of file
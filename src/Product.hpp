@@ -0,0 +1,305 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include "utils/DigitIterator.hpp"
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <utility>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+
+namespace FACore {
+    
+    enum class ProductOperation {
+        Intersection,
+        Union,
+        // Words of the left language that are not in the right one
+        Difference
+    };
+    
+    // Whether a pair of states accepts, INVALID_STATE is never final
+    inline bool ProductIsFinal(ProductOperation operation, bool leftFinal, bool rightFinal) {
+        switch(operation) {
+            case ProductOperation::Intersection:
+                return leftFinal && rightFinal;
+            case ProductOperation::Union:
+                return leftFinal || rightFinal;
+            case ProductOperation::Difference:
+            default:
+                return leftFinal && !rightFinal;
+        }
+    }
+    
+    // Whether no word can be accepted from a pair of states, given which of them is INVALID_STATE
+    inline bool ProductIsDead(ProductOperation operation, bool leftInvalid, bool rightInvalid) {
+        switch(operation) {
+            case ProductOperation::Intersection:
+                return leftInvalid || rightInvalid;
+            case ProductOperation::Union:
+                return leftInvalid && rightInvalid;
+            case ProductOperation::Difference:
+            default:
+                return leftInvalid;
+        }
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    struct ProductResult {
+        DAutomaton<ALPHABET_SIZE, StateIdType> automaton;
+        typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState;
+    };
+    
+    // Builds the product automaton of two DAutomatons, keeping only the pairs reachable
+    // from (leftInitial, rightInitial) in BFS order. A component that hits INVALID_STATE
+    // stays there, and pairs that can no longer accept become INVALID_STATE themselves.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    ProductResult<ALPHABET_SIZE, StateIdType> Product(
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &left, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId leftInitial,
+        const DAutomaton<ALPHABET_SIZE, StateIdType> &right, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId rightInitial,
+        ProductOperation operation)
+    {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        typedef std::pair<StateId, StateId> StatePair;
+        
+        ProductResult<ALPHABET_SIZE, StateIdType> result;
+        
+        std::unordered_map<StatePair, StateId, boost::hash<StatePair> > pairIds;
+        std::vector<StatePair> pairs;
+        
+        auto intern = [&](StateId leftState, StateId rightState) -> StateId {
+            if(ProductIsDead(operation, leftState == Machine::INVALID_STATE, rightState == Machine::INVALID_STATE)) {
+                return Machine::INVALID_STATE;
+            }
+            StatePair pair(leftState, rightState);
+            auto found = pairIds.find(pair);
+            if(found != pairIds.end()) {
+                return found->second;
+            }
+            StateId id = result.automaton.AddState(ProductIsFinal(operation, left.IsFinal(leftState), right.IsFinal(rightState)));
+            pairIds.emplace(pair, id);
+            pairs.push_back(pair);
+            return id;
+        };
+        
+        result.initialState = intern(
+            left.IsValidState(leftInitial) ? leftInitial : Machine::INVALID_STATE,
+            right.IsValidState(rightInitial) ? rightInitial : Machine::INVALID_STATE);
+        
+        for(std::size_t current = 0; current < pairs.size(); current++) {
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                StateId next = intern(left.GetNext(pairs[current].first, label), right.GetNext(pairs[current].second, label));
+                if(next != Machine::INVALID_STATE) {
+                    result.automaton.SetArc(current, label, next);
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> Product(const DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &left, const DRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &right, ProductOperation operation) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        
+        ProductResult<ALPHABET_SIZE, StateIdType> product = Product(*left.GetAutomaton(), left.GetInitialState(), *right.GetAutomaton(), right.GetInitialState(), operation);
+        std::shared_ptr<const Machine> automaton(new Machine(std::move(product.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation>(automaton, product.initialState);
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> Intersection(const DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &left, const DRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &right) {
+        return Product(left, right, ProductOperation::Intersection);
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> Union(const DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &left, const DRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &right) {
+        return Product(left, right, ProductOperation::Union);
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class LeftInstrumentation, class RightInstrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> Difference(const DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &left, const DRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &right) {
+        return Product(left, right, ProductOperation::Difference);
+    }
+    
+    // Flips every state's finality. INVALID_STATE is the implicit non-final sink, so
+    // in the complement it becomes one explicit final state looping on every label.
+    // The sink is only added when some arc or the initial state is INVALID_STATE.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    ProductResult<ALPHABET_SIZE, StateIdType> Complement(const DAutomaton<ALPHABET_SIZE, StateIdType> &automaton, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        ProductResult<ALPHABET_SIZE, StateIdType> result;
+        const StateId numStates = automaton.GetNumStates();
+        for(StateId state = 0; state < numStates; state++) {
+            result.automaton.AddState(!automaton.IsFinal(state));
+        }
+        
+        StateId sink = Machine::INVALID_STATE;
+        auto getSink = [&]() -> StateId {
+            if(sink == Machine::INVALID_STATE) {
+                sink = result.automaton.AddState(true);
+                for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                    result.automaton.SetArc(sink, label, sink);
+                }
+            }
+            return sink;
+        };
+        
+        for(StateId state = 0; state < numStates; state++) {
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                StateId next = automaton.GetNext(state, label);
+                result.automaton.SetArc(state, label, next == Machine::INVALID_STATE ? getSink() : next);
+            }
+        }
+        
+        result.initialState = automaton.IsValidState(initialState) ? initialState : getSink();
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> Complement(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        
+        ProductResult<ALPHABET_SIZE, StateIdType> complement = Complement(*language.GetAutomaton(), language.GetInitialState());
+        std::shared_ptr<const Machine> automaton(new Machine(std::move(complement.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>(automaton, complement.initialState);
+    }
+    
+    // Membership in the product of two languages without building it up front.
+    // Pairs of states are interned the first time a query reaches them and their
+    // transitions are memoized, so only the reachable pairs that queries actually
+    // touch are ever stored. Once maxStates pairs are cached the cache is flushed.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    class LazyProduct {
+        public:
+            typedef DRegularLanguage<ALPHABET_SIZE, StateIdType> Language;
+            typedef typename Language::Machine Machine;
+            typedef typename Machine::StateId StateId;
+            typedef typename Machine::Label Character;
+            
+            constexpr static unsigned int AlphabetSize = ALPHABET_SIZE;
+            constexpr static std::size_t DEFAULT_MAX_STATES = 1 << 16;
+        
+        private:
+            typedef DigitIterator<ALPHABET_SIZE, Character> Digitizer;
+            typedef unsigned int PairId;
+            typedef std::pair<StateId, StateId> StatePair;
+            
+            constexpr static PairId DEAD_PAIR = std::numeric_limits<PairId>::max();
+            constexpr static PairId UNKNOWN_PAIR = DEAD_PAIR - 1;
+        
+        public:
+            // Only the automata of the operands are used, whatever their Instrumentation
+            template<class LeftInstrumentation, class RightInstrumentation>
+            LazyProduct(const DRegularLanguage<ALPHABET_SIZE, StateIdType, LeftInstrumentation> &left, const DRegularLanguage<ALPHABET_SIZE, StateIdType, RightInstrumentation> &right, ProductOperation operation, std::size_t maxStates = DEFAULT_MAX_STATES) :
+                mLeft(left.GetAutomaton()), mRight(right.GetAutomaton()), mOperation(operation), mMaxStates(maxStates), mNumFlushes(0)
+            {
+                mLeftInitial = mLeft->IsValidState(left.GetInitialState()) ? left.GetInitialState() : Machine::INVALID_STATE;
+                mRightInitial = mRight->IsValidState(right.GetInitialState()) ? right.GetInitialState() : Machine::INVALID_STATE;
+                mInitialPair = Intern(mLeftInitial, mRightInitial);
+            }
+            
+            LazyProduct(LazyProduct&& other) = default;
+            
+            template<typename IterType>
+            bool contains(IterType begin, IterType end) {
+                if(mInitialPair == UNKNOWN_PAIR) {
+                    mInitialPair = Intern(mLeftInitial, mRightInitial);
+                }
+                PairId current = mInitialPair;
+                for(auto iter = begin; iter != end && current != DEAD_PAIR; ++iter) {
+                    Character c = *iter;
+                    if(c >= ALPHABET_SIZE) {
+                        // Both machines move to INVALID_STATE
+                        return false;
+                    }
+                    current = GetNext(current, c);
+                }
+                return current != DEAD_PAIR && mFinal[current];
+            }
+            
+            bool contains(unsigned int number) {
+                return contains(Digitizer(number), Digitizer::end());
+            }
+            
+            std::size_t GetNumStates() const {
+                return mPairs.size();
+            }
+            
+            std::size_t GetNumFlushes() const {
+                return mNumFlushes;
+            }
+        
+        private:
+            PairId GetNext(PairId src, Character c) {
+                PairId cached = mTransitions[static_cast<std::size_t>(src) * ALPHABET_SIZE + c];
+                if(cached != UNKNOWN_PAIR) {
+                    return cached;
+                }
+                std::size_t flushes = mNumFlushes;
+                PairId next = Intern(mLeft->GetNext(mPairs[src].first, c), mRight->GetNext(mPairs[src].second, c));
+                if(flushes == mNumFlushes) {
+                    mTransitions[static_cast<std::size_t>(src) * ALPHABET_SIZE + c] = next;
+                }
+                return next;
+            }
+            
+            PairId Intern(StateId leftState, StateId rightState) {
+                if(ProductIsDead(mOperation, leftState == Machine::INVALID_STATE, rightState == Machine::INVALID_STATE)) {
+                    return DEAD_PAIR;
+                }
+                StatePair pair(leftState, rightState);
+                auto found = mPairIds.find(pair);
+                if(found != mPairIds.end()) {
+                    return found->second;
+                }
+                if(mPairs.size() >= mMaxStates && !mPairs.empty()) {
+                    mPairIds.clear();
+                    mPairs.clear();
+                    mTransitions.clear();
+                    mFinal.clear();
+                    mInitialPair = UNKNOWN_PAIR;
+                    mNumFlushes++;
+                }
+                PairId id = mPairs.size();
+                mPairIds.emplace(pair, id);
+                mPairs.push_back(pair);
+                mTransitions.resize(mTransitions.size() + ALPHABET_SIZE, UNKNOWN_PAIR);
+                mFinal.push_back(ProductIsFinal(mOperation, mLeft->IsFinal(leftState), mRight->IsFinal(rightState)));
+                return id;
+            }
+            
+            std::shared_ptr<const Machine> mLeft;
+            std::shared_ptr<const Machine> mRight;
+            StateId mLeftInitial;
+            StateId mRightInitial;
+            ProductOperation mOperation;
+            std::size_t mMaxStates;
+            std::size_t mNumFlushes;
+            PairId mInitialPair;
+            
+            std::unordered_map<StatePair, PairId, boost::hash<StatePair> > mPairIds;
+            std::vector<StatePair> mPairs;
+            
+            // Indexed by pair * ALPHABET_SIZE + label
+            std::vector<PairId> mTransitions;
+            std::vector<bool> mFinal;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    constexpr std::size_t LazyProduct<ALPHABET_SIZE, StateIdType>::DEFAULT_MAX_STATES;
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    constexpr typename LazyProduct<ALPHABET_SIZE, StateIdType>::PairId LazyProduct<ALPHABET_SIZE, StateIdType>::DEAD_PAIR;
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    constexpr typename LazyProduct<ALPHABET_SIZE, StateIdType>::PairId LazyProduct<ALPHABET_SIZE, StateIdType>::UNKNOWN_PAIR;
+}
\ No newline at end of file
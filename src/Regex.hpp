@@ -0,0 +1,157 @@
+#pragma once
+
+#include "NAutomaton.hpp"
+#include "NAutomatonBuilder.hpp"
+#include "NRegularLanguage.hpp"
+#include "DRegularLanguage.hpp"
+#include "Determinize.hpp"
+#include "Minimize.hpp"
+#include "utils/RegexParser.hpp"
+
+#include <set>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace FACore {
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    struct RegexResult {
+        NAutomaton<ALPHABET_SIZE, StateIdType> automaton;
+        typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState;
+    };
+    
+    // Adds the states and arcs for node so that the paths from src to dest spell its language.
+    // src and dest may be the same state, which is how a star loops back on itself. Every node
+    // adds at most two states and a constant number of arcs besides the arcs of its labels.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    void AddRegexArcs(const std::vector<typename RegexParser<ALPHABET_SIZE>::Node> &nodes, std::size_t index,
+                      typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId src,
+                      typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId dest,
+                      NAutomatonBuilder<ALPHABET_SIZE, StateIdType> &builder) {
+        typedef RegexParser<ALPHABET_SIZE> Parser;
+        typedef typename Parser::NodeKind NodeKind;
+        typedef typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId StateId;
+        
+        const typename Parser::Node &node = nodes[index];
+        switch(node.kind) {
+            case NodeKind::Labels:
+                for(unsigned int label = 0; label < ALPHABET_SIZE; label++) {
+                    if(node.labels[label]) {
+                        builder.AddArc(src, label, dest);
+                    }
+                }
+                break;
+            case NodeKind::Concatenation: {
+                if(node.children.empty()) {
+                    if(src != dest) {
+                        builder.AddEpsilonArc(src, dest);
+                    }
+                    break;
+                }
+                StateId current = src;
+                for(std::size_t child = 0; child < node.children.size(); child++) {
+                    StateId next = child + 1 == node.children.size() ? dest : builder.AddState(false);
+                    AddRegexArcs(nodes, node.children[child], current, next, builder);
+                    current = next;
+                }
+                break;
+            }
+            case NodeKind::Alternation:
+                for(std::size_t child : node.children) {
+                    AddRegexArcs(nodes, child, src, dest, builder);
+                }
+                break;
+            case NodeKind::Star: {
+                StateId loop = builder.AddState(false);
+                builder.AddEpsilonArc(src, loop);
+                AddRegexArcs(nodes, node.children.front(), loop, loop, builder);
+                builder.AddEpsilonArc(loop, dest);
+                break;
+            }
+            case NodeKind::Plus: {
+                StateId loopStart = builder.AddState(false);
+                StateId loopEnd = builder.AddState(false);
+                builder.AddEpsilonArc(src, loopStart);
+                AddRegexArcs(nodes, node.children.front(), loopStart, loopEnd, builder);
+                builder.AddEpsilonArc(loopEnd, loopStart);
+                builder.AddEpsilonArc(loopEnd, dest);
+                break;
+            }
+            case NodeKind::Optional:
+                if(src != dest) {
+                    builder.AddEpsilonArc(src, dest);
+                }
+                AddRegexArcs(nodes, node.children.front(), src, dest, builder);
+                break;
+            case NodeKind::Repetition: {
+                // minCount copies in a row, then either a star or maxCount - minCount copies
+                // that may each be skipped to dest
+                const std::size_t child = node.children.front();
+                StateId current = src;
+                for(unsigned int copy = 0; copy < node.minCount; copy++) {
+                    const bool last = copy + 1 == node.minCount && !node.unbounded && node.maxCount == node.minCount;
+                    StateId next = last ? dest : builder.AddState(false);
+                    AddRegexArcs(nodes, child, current, next, builder);
+                    current = next;
+                }
+                if(node.unbounded) {
+                    StateId loop = builder.AddState(false);
+                    builder.AddEpsilonArc(current, loop);
+                    AddRegexArcs(nodes, child, loop, loop, builder);
+                    builder.AddEpsilonArc(loop, dest);
+                } else if(node.maxCount == 0) {
+                    if(src != dest) {
+                        builder.AddEpsilonArc(src, dest);
+                    }
+                } else {
+                    for(unsigned int copy = node.minCount; copy < node.maxCount; copy++) {
+                        if(current != dest) {
+                            builder.AddEpsilonArc(current, dest);
+                        }
+                        StateId next = copy + 1 == node.maxCount ? dest : builder.AddState(false);
+                        AddRegexArcs(nodes, child, current, next, builder);
+                        current = next;
+                    }
+                }
+                break;
+            }
+        }
+    }
+    
+    // A Thompson style construction: one initial and one final state, epsilon arcs for the
+    // operators. The automaton has O(m) states and O(m * ALPHABET_SIZE) arcs for a pattern
+    // of m symbols, with bounded repetitions counted by their expanded size. That size is
+    // capped at REGEX_MAX_EXPANDED_SIZE, so nested repetitions cannot multiply without bound.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    RegexResult<ALPHABET_SIZE, StateIdType> RegexToNAutomaton(const std::string &pattern) {
+        RegexParser<ALPHABET_SIZE> parser(pattern);
+        
+        NAutomatonBuilder<ALPHABET_SIZE, StateIdType> builder;
+        auto initialState = builder.AddState(false);
+        auto finalState = builder.AddState(true);
+        AddRegexArcs(parser.GetNodes(), parser.GetRoot(), initialState, finalState, builder);
+        return RegexResult<ALPHABET_SIZE, StateIdType> {builder.Freeze(), initialState};
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    NRegularLanguage<ALPHABET_SIZE, StateIdType> CompileRegex(const std::string &pattern, SimulationMode mode = SimulationMode::StateSet) {
+        typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        
+        RegexResult<ALPHABET_SIZE, StateIdType> compiled = RegexToNAutomaton<ALPHABET_SIZE, StateIdType>(pattern);
+        std::shared_ptr<const Machine> automaton(new Machine(std::move(compiled.automaton)));
+        return NRegularLanguage<ALPHABET_SIZE, StateIdType>(automaton, {compiled.initialState}, mode);
+    }
+    
+    // Determinized and minimized, subset construction may take exponential time for some patterns
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType> CompileMinimalRegex(const std::string &pattern) {
+        RegexResult<ALPHABET_SIZE, StateIdType> compiled = RegexToNAutomaton<ALPHABET_SIZE, StateIdType>(pattern);
+        DeterminizeResult<ALPHABET_SIZE, StateIdType> determinized = Determinize(compiled.automaton, {compiled.initialState});
+        MinimizeResult<ALPHABET_SIZE, StateIdType> minimized = Minimize(determinized.automaton, determinized.initialState);
+        
+        std::shared_ptr<const DAutomaton<ALPHABET_SIZE, StateIdType> > automaton(new DAutomaton<ALPHABET_SIZE, StateIdType>(std::move(minimized.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType>(automaton, minimized.initialState);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "NAutomaton.hpp"
+#include "NAutomatonBuilder.hpp"
+#include "NRegularLanguage.hpp"
+#include "utils/EpsilonClosure.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace FACore {
+    
+    // An equivalent NAutomaton without epsilon arcs, over the same states and for the
+    // same initial states. Each state takes over the labelled arcs of its closure and
+    // is final if its closure holds a final state. Parallel arcs are merged and the
+    // result is frozen.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    NAutomaton<ALPHABET_SIZE, StateIdType> RemoveEpsilons(const NAutomaton<ALPHABET_SIZE, StateIdType> &automaton) {
+        typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        const StateId numStates = automaton.GetNumStates();
+        const EpsilonClosure<Machine> closure(automaton);
+        
+        NAutomatonBuilder<ALPHABET_SIZE, StateIdType> builder;
+        for(StateId state = 0; state < numStates; state++) {
+            bool isFinal = false;
+            for(StateId member : closure.GetClosure(state)) {
+                isFinal = isFinal || automaton.IsFinal(member);
+            }
+            builder.AddState(isFinal);
+        }
+        
+        // added[dest] == key + 1 once the arc (state, label, dest) was added
+        std::vector<std::size_t> added(numStates, 0);
+        for(StateId state = 0; state < numStates; state++) {
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                const std::size_t mark = static_cast<std::size_t>(state) * ALPHABET_SIZE + label + 1;
+                for(StateId member : closure.GetClosure(state)) {
+                    for(auto &arc : automaton.GetNext(member, label)) {
+                        StateId dest = ArcDestination(arc);
+                        if(added[dest] != mark) {
+                            added[dest] = mark;
+                            builder.AddArc(state, label, dest);
+                        }
+                    }
+                }
+            }
+        }
+        return builder.Freeze();
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> RemoveEpsilons(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        typedef NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> Language;
+        typedef typename Language::Machine Machine;
+        
+        std::shared_ptr<const Machine> automaton(new Machine(RemoveEpsilons(*language.GetAutomaton())));
+        return Language(automaton, language.GetInitialStates(), language.GetSimulationMode(), language.GetCacheBudget());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,317 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "NAutomatonBuilder.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // On-disk layout, in native byte order, every section starting on an 8 byte boundary:
+    //   AutomatonFileHeader
+    //   DAutomaton: numStates * ALPHABET_SIZE StateIds, row by row
+    //   NAutomaton: numStates * ALPHABET_SIZE + 1 uint64 CSR offsets, then numArcs destination StateIds
+    //   ceil(numStates / 64) uint64 words of final state bits, state i is bit i % 64 of word i / 64
+    //   NAutomaton, since version 2: numStates + 1 uint64 CSR offsets, then the epsilon arc destination StateIds
+    // Files written on a machine of the other byte order are rejected rather than swapped.
+    // Older versions stay readable.
+    constexpr std::uint32_t AUTOMATON_FORMAT_VERSION = 2;
+    constexpr std::uint32_t AUTOMATON_BYTE_ORDER_MARK = 0x01020304;
+    
+    enum class AutomatonKind : std::uint32_t {
+        Deterministic = 1,
+        Nondeterministic = 2
+    };
+    
+    struct AutomatonFileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        AutomatonKind kind;
+        std::uint32_t alphabetSize;
+        std::uint32_t stateIdSize;
+        std::uint32_t reserved;
+        std::uint64_t numStates;
+        
+        // Only used by NAutomaton files
+        std::uint64_t numArcs;
+    };
+    
+    static_assert(sizeof(AutomatonFileHeader) == 48, "AutomatonFileHeader must not contain padding");
+    
+    inline const char* AutomatonFileMagic() {
+        return "FACORE\0";
+    }
+    
+    // Bytes needed to bring a section of the given size to the next 8 byte boundary
+    inline std::size_t AutomatonFilePadding(std::uint64_t size) {
+        return static_cast<std::size_t>((8 - size % 8) % 8);
+    }
+    
+    inline std::uint64_t AutomatonFileFinalWords(std::uint64_t numStates) {
+        return (numStates + 63) / 64;
+    }
+    
+    inline AutomatonFileHeader MakeAutomatonFileHeader(AutomatonKind kind, std::uint32_t alphabetSize, std::uint32_t stateIdSize, std::uint64_t numStates, std::uint64_t numArcs) {
+        AutomatonFileHeader header;
+        std::memcpy(header.magic, AutomatonFileMagic(), sizeof(header.magic));
+        header.version = AUTOMATON_FORMAT_VERSION;
+        header.byteOrder = AUTOMATON_BYTE_ORDER_MARK;
+        header.kind = kind;
+        header.alphabetSize = alphabetSize;
+        header.stateIdSize = stateIdSize;
+        header.reserved = 0;
+        header.numStates = numStates;
+        header.numArcs = numArcs;
+        return header;
+    }
+    
+    // Throws if the header does not describe an automaton of the expected type
+    inline void CheckAutomatonFileHeader(const AutomatonFileHeader &header, AutomatonKind kind, std::uint32_t alphabetSize, std::uint32_t stateIdSize, std::uint64_t invalidState) {
+        if(std::memcmp(header.magic, AutomatonFileMagic(), sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Not an automaton file");
+        }
+        if(header.byteOrder != AUTOMATON_BYTE_ORDER_MARK) {
+            throw std::runtime_error("Automaton file was written with another byte order");
+        }
+        if(header.version == 0 || header.version > AUTOMATON_FORMAT_VERSION) {
+            throw std::runtime_error("Unsupported automaton file version");
+        }
+        if(header.kind != kind) {
+            throw std::runtime_error("Automaton file holds another kind of automaton");
+        }
+        if(header.alphabetSize != alphabetSize) {
+            throw std::runtime_error("Automaton file has another alphabet size");
+        }
+        if(header.stateIdSize != stateIdSize) {
+            throw std::runtime_error("Automaton file has another StateId width");
+        }
+        if(header.numStates >= invalidState) {
+            throw std::runtime_error("Automaton file has too many states");
+        }
+    }
+    
+    inline void WriteAutomatonSection(std::ostream &out, const void *data, std::uint64_t size) {
+        static const char zeros[8] = {0};
+        out.write(static_cast<const char*>(data), size);
+        out.write(zeros, AutomatonFilePadding(size));
+    }
+    
+    inline void ReadAutomatonSection(std::istream &in, void *data, std::uint64_t size) {
+        char padding[8];
+        in.read(static_cast<char*>(data), size);
+        in.read(padding, AutomatonFilePadding(size));
+        if(!in) {
+            throw std::runtime_error("Automaton file is truncated");
+        }
+    }
+    
+    // Reads a section of count items without trusting count, which comes from the file:
+    // the vector grows one chunk at a time as the data arrives, so a corrupt header cannot
+    // make it allocate much more than the stream actually holds.
+    template<typename T>
+    std::vector<T> ReadAutomatonArray(std::istream &in, std::uint64_t count) {
+        if(count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::runtime_error("Automaton file section is too large");
+        }
+        const std::size_t CHUNK_ITEMS = std::max<std::size_t>(1, (1 << 20) / sizeof(T));
+        
+        std::vector<T> items;
+        while(items.size() < count) {
+            std::size_t read = items.size();
+            items.resize(read + std::min<std::uint64_t>(CHUNK_ITEMS, count - read));
+            in.read(reinterpret_cast<char*>(items.data() + read), (items.size() - read) * sizeof(T));
+            if(!in) {
+                throw std::runtime_error("Automaton file is truncated");
+            }
+        }
+        char padding[8];
+        in.read(padding, AutomatonFilePadding(count * sizeof(T)));
+        if(!in) {
+            throw std::runtime_error("Automaton file is truncated");
+        }
+        return items;
+    }
+    
+    template<typename IsFinal>
+    std::vector<std::uint64_t> PackFinalStates(std::uint64_t numStates, IsFinal isFinal) {
+        std::vector<std::uint64_t> words(AutomatonFileFinalWords(numStates), 0);
+        for(std::uint64_t state = 0; state < numStates; state++) {
+            if(isFinal(state)) {
+                words[state / 64] |= std::uint64_t(1) << (state % 64);
+            }
+        }
+        return words;
+    }
+    
+    inline boost::dynamic_bitset<> UnpackFinalStates(std::uint64_t numStates, const std::vector<std::uint64_t> &words) {
+        boost::dynamic_bitset<> finalStates(numStates);
+        for(std::uint64_t state = 0; state < numStates; state++) {
+            finalStates[state] = (words[state / 64] >> (state % 64)) & 1;
+        }
+        return finalStates;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    void SaveAutomaton(const DAutomaton<ALPHABET_SIZE, StateIdType> &automaton, std::ostream &out) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        static_assert(sizeof(typename Machine::TransitionArr) == ALPHABET_SIZE * sizeof(StateIdType), "TransitionArr must be tightly packed");
+        
+        const std::uint64_t numStates = automaton.GetNumStates();
+        AutomatonFileHeader header = MakeAutomatonFileHeader(AutomatonKind::Deterministic, ALPHABET_SIZE, sizeof(StateIdType), numStates, 0);
+        WriteAutomatonSection(out, &header, sizeof(header));
+        WriteAutomatonSection(out, automaton.GetTransitionTable(), numStates * sizeof(typename Machine::TransitionArr));
+        
+        std::vector<std::uint64_t> words = PackFinalStates(numStates, [&](std::uint64_t state) { return automaton.IsFinal(state); });
+        WriteAutomatonSection(out, words.data(), words.size() * sizeof(std::uint64_t));
+        if(!out) {
+            throw std::runtime_error("Could not write automaton");
+        }
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    void SaveAutomaton(const NAutomaton<ALPHABET_SIZE, StateIdType> &automaton, std::ostream &out) {
+        typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        
+        const std::uint64_t numStates = automaton.GetNumStates();
+        std::vector<std::uint64_t> offsets(1, 0);
+        std::vector<StateIdType> destinations;
+        for(StateIdType state = 0; state < numStates; state++) {
+            for(typename Machine::Label label = 0; label < ALPHABET_SIZE; label++) {
+                for(auto &arc : automaton.GetNext(state, label)) {
+                    destinations.push_back(ArcDestination(arc));
+                }
+                offsets.push_back(destinations.size());
+            }
+        }
+        
+        AutomatonFileHeader header = MakeAutomatonFileHeader(AutomatonKind::Nondeterministic, ALPHABET_SIZE, sizeof(StateIdType), numStates, destinations.size());
+        WriteAutomatonSection(out, &header, sizeof(header));
+        WriteAutomatonSection(out, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+        WriteAutomatonSection(out, destinations.data(), destinations.size() * sizeof(StateIdType));
+        
+        std::vector<std::uint64_t> words = PackFinalStates(numStates, [&](std::uint64_t state) { return automaton.IsFinal(state); });
+        WriteAutomatonSection(out, words.data(), words.size() * sizeof(std::uint64_t));
+        
+        std::vector<std::uint64_t> epsilonOffsets(1, 0);
+        std::vector<StateIdType> epsilonDestinations;
+        for(StateIdType state = 0; state < numStates; state++) {
+            for(auto &arc : automaton.GetEpsilonNext(state)) {
+                epsilonDestinations.push_back(arc.second);
+            }
+            epsilonOffsets.push_back(epsilonDestinations.size());
+        }
+        WriteAutomatonSection(out, epsilonOffsets.data(), epsilonOffsets.size() * sizeof(std::uint64_t));
+        WriteAutomatonSection(out, epsilonDestinations.data(), epsilonDestinations.size() * sizeof(StateIdType));
+        if(!out) {
+            throw std::runtime_error("Could not write automaton");
+        }
+    }
+    
+    template<typename Automaton>
+    void SaveAutomaton(const Automaton &automaton, const std::string &path) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if(!out) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        SaveAutomaton(automaton, out);
+    }
+    
+    // The table is validated once by the DAutomaton constructor
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    DAutomaton<ALPHABET_SIZE, StateIdType> LoadDAutomaton(std::istream &in) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        
+        AutomatonFileHeader header;
+        ReadAutomatonSection(in, &header, sizeof(header));
+        CheckAutomatonFileHeader(header, AutomatonKind::Deterministic, ALPHABET_SIZE, sizeof(StateIdType), Machine::INVALID_STATE);
+        
+        std::vector<typename Machine::TransitionArr> transitions = ReadAutomatonArray<typename Machine::TransitionArr>(in, header.numStates);
+        std::vector<std::uint64_t> words = ReadAutomatonArray<std::uint64_t>(in, AutomatonFileFinalWords(header.numStates));
+        
+        return Machine(std::move(transitions), UnpackFinalStates(header.numStates, words));
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    DAutomaton<ALPHABET_SIZE, StateIdType> LoadDAutomaton(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if(!in) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        return LoadDAutomaton<ALPHABET_SIZE, StateIdType>(in);
+    }
+    
+    // The result is frozen
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    NAutomaton<ALPHABET_SIZE, StateIdType> LoadNAutomaton(std::istream &in) {
+        typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        
+        AutomatonFileHeader header;
+        ReadAutomatonSection(in, &header, sizeof(header));
+        CheckAutomatonFileHeader(header, AutomatonKind::Nondeterministic, ALPHABET_SIZE, sizeof(StateIdType), Machine::INVALID_STATE);
+        
+        if(header.numStates > (std::numeric_limits<std::uint64_t>::max() - 1) / ALPHABET_SIZE) {
+            throw std::runtime_error("Automaton file has too many states");
+        }
+        std::vector<std::uint64_t> offsets = ReadAutomatonArray<std::uint64_t>(in, header.numStates * ALPHABET_SIZE + 1);
+        if(offsets.front() != 0 || offsets.back() != header.numArcs) {
+            throw std::runtime_error("Automaton file has inconsistent offsets");
+        }
+        
+        std::vector<StateIdType> destinations = ReadAutomatonArray<StateIdType>(in, header.numArcs);
+        std::vector<std::uint64_t> words = ReadAutomatonArray<std::uint64_t>(in, AutomatonFileFinalWords(header.numStates));
+        
+        NAutomatonBuilder<ALPHABET_SIZE, StateIdType> builder;
+        boost::dynamic_bitset<> finalStates = UnpackFinalStates(header.numStates, words);
+        for(std::uint64_t state = 0; state < header.numStates; state++) {
+            builder.AddState(finalStates[state]);
+        }
+        for(std::size_t key = 0; key + 1 < offsets.size(); key++) {
+            if(offsets[key] > offsets[key + 1] || offsets[key + 1] > header.numArcs) {
+                throw std::runtime_error("Automaton file has inconsistent offsets");
+            }
+            for(std::uint64_t arc = offsets[key]; arc < offsets[key + 1]; arc++) {
+                builder.AddArc(key / ALPHABET_SIZE, key % ALPHABET_SIZE, destinations[arc]);
+            }
+        }
+        
+        if(header.version >= 2) {
+            std::vector<std::uint64_t> epsilonOffsets = ReadAutomatonArray<std::uint64_t>(in, header.numStates + 1);
+            if(epsilonOffsets.front() != 0) {
+                throw std::runtime_error("Automaton file has inconsistent epsilon offsets");
+            }
+            
+            std::vector<StateIdType> epsilonDestinations = ReadAutomatonArray<StateIdType>(in, epsilonOffsets.back());
+            for(std::uint64_t state = 0; state < header.numStates; state++) {
+                if(epsilonOffsets[state] > epsilonOffsets[state + 1]) {
+                    throw std::runtime_error("Automaton file has inconsistent epsilon offsets");
+                }
+                for(std::uint64_t arc = epsilonOffsets[state]; arc < epsilonOffsets[state + 1]; arc++) {
+                    builder.AddEpsilonArc(state, epsilonDestinations[arc]);
+                }
+            }
+        }
+        return builder.Freeze();
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    NAutomaton<ALPHABET_SIZE, StateIdType> LoadNAutomaton(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if(!in) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        return LoadNAutomaton<ALPHABET_SIZE, StateIdType>(in);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "NAutomatonBuilder.hpp"
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+
+namespace FACore {
+    
+    // The narrowest unsigned type that can number MaxStates states while keeping
+    // its maximum value free for INVALID_STATE, so 255 states still fit uint8_t
+    template<unsigned long long MaxStates>
+    struct CompactStateId {
+        typedef typename std::conditional<(MaxStates <= 0xffull), std::uint8_t,
+                typename std::conditional<(MaxStates <= 0xffffull), std::uint16_t,
+                typename std::conditional<(MaxStates <= 0xffffffffull), std::uint32_t,
+                std::uint64_t>::type>::type>::type type;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, unsigned long long MaxStates>
+    using CompactDAutomaton = DAutomaton<ALPHABET_SIZE, typename CompactStateId<MaxStates>::type>;
+    
+    template<unsigned int ALPHABET_SIZE, unsigned long long MaxStates>
+    using CompactNAutomaton = NAutomaton<ALPHABET_SIZE, typename CompactStateId<MaxStates>::type>;
+    
+    // State ids keep their value, INVALID_STATE of one width maps to INVALID_STATE of the other
+    template<typename ToStateId, typename FromStateId>
+    ToStateId ConvertStateId(FromStateId state) {
+        if(state == std::numeric_limits<FromStateId>::max()) {
+            return std::numeric_limits<ToStateId>::max();
+        }
+        if(state >= std::numeric_limits<ToStateId>::max()) {
+            throw std::out_of_range("State does not fit the target StateId width");
+        }
+        return static_cast<ToStateId>(state);
+    }
+    
+    template<typename ToStateId, unsigned int ALPHABET_SIZE, typename FromStateId>
+    DAutomaton<ALPHABET_SIZE, ToStateId> ConvertStateWidth(const DAutomaton<ALPHABET_SIZE, FromStateId> &automaton) {
+        typedef DAutomaton<ALPHABET_SIZE, FromStateId> FromMachine;
+        
+        if(static_cast<unsigned long long>(automaton.GetNumStates()) > std::numeric_limits<ToStateId>::max()) {
+            throw std::out_of_range("Too many states for the target StateId width");
+        }
+        
+        DAutomaton<ALPHABET_SIZE, ToStateId> result;
+        for(FromStateId state = 0; state < automaton.GetNumStates(); state++) {
+            result.AddState(automaton.IsFinal(state));
+        }
+        for(FromStateId state = 0; state < automaton.GetNumStates(); state++) {
+            for(typename FromMachine::Label label = 0; label < ALPHABET_SIZE; label++) {
+                FromStateId next = automaton.GetNext(state, label);
+                if(next != FromMachine::INVALID_STATE) {
+                    result.SetArc(static_cast<ToStateId>(state), label, static_cast<ToStateId>(next));
+                }
+            }
+        }
+        return result;
+    }
+    
+    // The result is frozen
+    template<typename ToStateId, unsigned int ALPHABET_SIZE, typename FromStateId>
+    NAutomaton<ALPHABET_SIZE, ToStateId> ConvertStateWidth(const NAutomaton<ALPHABET_SIZE, FromStateId> &automaton) {
+        typedef NAutomaton<ALPHABET_SIZE, FromStateId> FromMachine;
+        
+        if(static_cast<unsigned long long>(automaton.GetNumStates()) > std::numeric_limits<ToStateId>::max()) {
+            throw std::out_of_range("Too many states for the target StateId width");
+        }
+        
+        NAutomatonBuilder<ALPHABET_SIZE, ToStateId> builder;
+        for(FromStateId state = 0; state < automaton.GetNumStates(); state++) {
+            builder.AddState(automaton.IsFinal(state));
+        }
+        for(FromStateId state = 0; state < automaton.GetNumStates(); state++) {
+            for(typename FromMachine::Label label = 0; label < ALPHABET_SIZE; label++) {
+                for(auto &arc : automaton.GetNext(state, label)) {
+                    builder.AddArc(static_cast<ToStateId>(state), label, static_cast<ToStateId>(ArcDestination(arc)));
+                }
+            }
+            for(auto &arc : automaton.GetEpsilonNext(state)) {
+                builder.AddEpsilonArc(static_cast<ToStateId>(state), static_cast<ToStateId>(arc.second));
+            }
+        }
+        return builder.Freeze();
+    }
+    
+    template<typename ToStateId, unsigned int ALPHABET_SIZE, typename FromStateId, class Instrumentation>
+    DRegularLanguage<ALPHABET_SIZE, ToStateId, Instrumentation> ConvertStateWidth(const DRegularLanguage<ALPHABET_SIZE, FromStateId, Instrumentation> &language) {
+        typedef DAutomaton<ALPHABET_SIZE, ToStateId> ToMachine;
+        
+        std::shared_ptr<const ToMachine> automaton(new ToMachine(ConvertStateWidth<ToStateId>(*language.GetAutomaton())));
+        return DRegularLanguage<ALPHABET_SIZE, ToStateId, Instrumentation>(automaton, ConvertStateId<ToStateId>(language.GetInitialState()));
+    }
+    
+    template<typename ToStateId, unsigned int ALPHABET_SIZE, typename FromStateId, class Instrumentation>
+    NRegularLanguage<ALPHABET_SIZE, ToStateId, Instrumentation> ConvertStateWidth(const NRegularLanguage<ALPHABET_SIZE, FromStateId, Instrumentation> &language) {
+        typedef NAutomaton<ALPHABET_SIZE, ToStateId> ToMachine;
+        
+        std::shared_ptr<const ToMachine> automaton(new ToMachine(ConvertStateWidth<ToStateId>(*language.GetAutomaton())));
+        std::set<ToStateId> initialStates;
+        for(FromStateId state : language.GetInitialStates()) {
+            if(language.GetAutomaton()->IsValidState(state)) {
+                initialStates.insert(static_cast<ToStateId>(state));
+            }
+        }
+        return NRegularLanguage<ALPHABET_SIZE, ToStateId, Instrumentation>(automaton, initialStates, language.GetSimulationMode(), language.GetCacheBudget());
+    }
+}
\ No newline at end of file
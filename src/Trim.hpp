@@ -0,0 +1,190 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "DAutomatonBuilder.hpp"
+#include "NAutomatonBuilder.hpp"
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+#include "utils/EpsilonClosure.hpp"
+#include "utils/DecidedStates.hpp"
+
+#include <set>
+#include <vector>
+#include <memory>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    struct DTrimResult {
+        DAutomaton<ALPHABET_SIZE, StateIdType> automaton;
+        typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState;
+        
+        // States that were unreachable or could not reach a final state
+        typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId removedStates;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    struct NTrimResult {
+        NAutomaton<ALPHABET_SIZE, StateIdType> automaton;
+        std::set<typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId> initialStates;
+        
+        // States that were unreachable or could not reach a final state
+        typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId removedStates;
+    };
+    
+    // Keeps the states that are reachable from initialState and can reach a final state.
+    // They are renumbered densely in their original order, arcs into removed states are
+    // left as INVALID_STATE. When nothing is accepted the result is empty, with an
+    // INVALID_STATE initial state.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    DTrimResult<ALPHABET_SIZE, StateIdType> Trim(const DAutomaton<ALPHABET_SIZE, StateIdType> &dfa, typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId initialState) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        const StateId numStates = dfa.GetNumStates();
+        const DecidedStates decided = FindDecidedStates(dfa);
+        
+        boost::dynamic_bitset<> kept(numStates);
+        std::vector<StateId> stack;
+        if(dfa.IsValidState(initialState) && !decided.dead[initialState]) {
+            kept.set(initialState);
+            stack.push_back(initialState);
+        }
+        while(!stack.empty()) {
+            StateId src = stack.back();
+            stack.pop_back();
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                StateId dest = dfa.GetNext(src, label);
+                if(dest != Machine::INVALID_STATE && !decided.dead[dest] && !kept[dest]) {
+                    kept.set(dest);
+                    stack.push_back(dest);
+                }
+            }
+        }
+        
+        // Kept states are renumbered in their original order
+        std::vector<StateId> ids(numStates, Machine::INVALID_STATE);
+        StateId numKept = 0;
+        for(auto state = kept.find_first(); state != boost::dynamic_bitset<>::npos; state = kept.find_next(state)) {
+            ids[state] = numKept++;
+        }
+        DAutomatonBuilder<ALPHABET_SIZE, StateIdType> builder;
+        builder.Reserve(numKept);
+        std::vector<typename DAutomatonBuilder<ALPHABET_SIZE, StateIdType>::Arc> arcs;
+        for(auto state = kept.find_first(); state != boost::dynamic_bitset<>::npos; state = kept.find_next(state)) {
+            builder.AddState(dfa.IsFinal(state));
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                StateId dest = dfa.GetNext(state, label);
+                if(dest != Machine::INVALID_STATE && kept[dest]) {
+                    arcs.push_back({ids[state], label, ids[dest]});
+                }
+            }
+        }
+        builder.SetArcs(arcs);
+        
+        DTrimResult<ALPHABET_SIZE, StateIdType> result;
+        result.automaton = builder.Freeze();
+        result.initialState = dfa.IsValidState(initialState) ? ids[initialState] : Machine::INVALID_STATE;
+        result.removedStates = numStates - result.automaton.GetNumStates();
+        return result;
+    }
+    
+    // The NAutomaton counterpart, reachability follows both labelled and epsilon arcs.
+    // Initial states that were removed are dropped from the initial set.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    NTrimResult<ALPHABET_SIZE, StateIdType> Trim(const NAutomaton<ALPHABET_SIZE, StateIdType> &nfa, const std::set<typename NAutomaton<ALPHABET_SIZE, StateIdType>::StateId> &initialStates) {
+        typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        typedef NAutomatonBuilder<ALPHABET_SIZE, StateIdType> Builder;
+        
+        const StateId numStates = nfa.GetNumStates();
+        const DecidedStates decided = FindDecidedStates(nfa, EpsilonClosure<Machine>(nfa));
+        
+        boost::dynamic_bitset<> kept(numStates);
+        std::vector<StateId> stack;
+        auto visit = [&](StateId state) {
+            if(!decided.dead[state] && !kept[state]) {
+                kept.set(state);
+                stack.push_back(state);
+            }
+        };
+        for(StateId state : initialStates) {
+            if(nfa.IsValidState(state)) {
+                visit(state);
+            }
+        }
+        while(!stack.empty()) {
+            StateId src = stack.back();
+            stack.pop_back();
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                for(auto &arc : nfa.GetNext(src, label)) {
+                    visit(ArcDestination(arc));
+                }
+            }
+            for(auto &arc : nfa.GetEpsilonNext(src)) {
+                visit(arc.second);
+            }
+        }
+        
+        // Kept states are renumbered in their original order
+        std::vector<StateId> ids(numStates, Machine::INVALID_STATE);
+        StateId numKept = 0;
+        for(auto state = kept.find_first(); state != boost::dynamic_bitset<>::npos; state = kept.find_next(state)) {
+            ids[state] = numKept++;
+        }
+        Builder builder;
+        std::vector<typename Builder::Arc> arcs;
+        for(auto state = kept.find_first(); state != boost::dynamic_bitset<>::npos; state = kept.find_next(state)) {
+            builder.AddState(nfa.IsFinal(state));
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                for(auto &arc : nfa.GetNext(state, label)) {
+                    if(kept[ArcDestination(arc)]) {
+                        arcs.push_back({ids[state], label, ids[ArcDestination(arc)]});
+                    }
+                }
+            }
+        }
+        builder.AddArcs(arcs);
+        for(auto state = kept.find_first(); state != boost::dynamic_bitset<>::npos; state = kept.find_next(state)) {
+            for(auto &arc : nfa.GetEpsilonNext(state)) {
+                if(kept[arc.second]) {
+                    builder.AddEpsilonArc(ids[state], ids[arc.second]);
+                }
+            }
+        }
+        
+        NTrimResult<ALPHABET_SIZE, StateIdType> result;
+        result.automaton = builder.Freeze();
+        for(StateId state : initialStates) {
+            if(nfa.IsValidState(state) && kept[state]) {
+                result.initialStates.insert(ids[state]);
+            }
+        }
+        result.removedStates = numStates - result.automaton.GetNumStates();
+        return result;
+    }
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> Trim(const DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        DTrimResult<ALPHABET_SIZE, StateIdType> trimmed = Trim(*language.GetAutomaton(), language.GetInitialState());
+        
+        std::shared_ptr<const DAutomaton<ALPHABET_SIZE, StateIdType> > automaton(new DAutomaton<ALPHABET_SIZE, StateIdType>(std::move(trimmed.automaton)));
+        return DRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation>(automaton, trimmed.initialState);
+    }
+    
+    // Keeps the simulation mode and cache budget of the language
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, class Instrumentation>
+    NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> Trim(const NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> &language) {
+        typedef NRegularLanguage<ALPHABET_SIZE, StateIdType, Instrumentation> Language;
+        typedef typename Language::Machine Machine;
+        
+        NTrimResult<ALPHABET_SIZE, StateIdType> trimmed = Trim(*language.GetAutomaton(), language.GetInitialStates());
+        std::shared_ptr<const Machine> automaton(new Machine(std::move(trimmed.automaton)));
+        return Language(automaton, trimmed.initialStates, language.GetSimulationMode(), language.GetCacheBudget());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "../DAutomaton.hpp"
+#include "../NAutomaton.hpp"
+#include "EpsilonClosure.hpp"
+
+#include <vector>
+#include <cstddef>
+#include <functional>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // States that settle a membership query before the input ends. No word leads from a
+    // dead state to a final state, so a query that reaches one is rejected. Every word,
+    // the empty one included, leads from an accepting state to a final state, so a query
+    // that reaches one is accepted.
+    struct DecidedStates {
+        boost::dynamic_bitset<> dead;
+        boost::dynamic_bitset<> accepting;
+    };
+    
+    // Accepting states only cover words over the alphabet. A query that stops at one must
+    // still reject the input if a label outside the alphabet follows.
+    template<unsigned int ALPHABET_SIZE, typename IterType>
+    bool AllLabelsValid(IterType begin, IterType end) {
+        for(auto iter = begin; iter != end; ++iter) {
+            unsigned int label = *iter;
+            if(label >= ALPHABET_SIZE) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Sources of the arcs into each state, in compressed sparse rows
+    struct ReverseArcs {
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> sources;
+        
+        template<class AddArcs>
+        ReverseArcs(std::size_t numStates, AddArcs addArcs) : offsets(numStates + 2, 0) {
+            addArcs([&](std::size_t, std::size_t dest) { offsets[dest + 2]++; });
+            for(std::size_t i = 2; i < offsets.size(); i++) {
+                offsets[i] += offsets[i - 1];
+            }
+            sources.resize(offsets.back());
+            addArcs([&](std::size_t src, std::size_t dest) { sources[offsets[dest + 1]++] = src; });
+            offsets.pop_back();
+        }
+    };
+    
+    // Marks every state that can reach a state of found, found must be a fixpoint afterwards
+    inline void MarkBackwards(const ReverseArcs &reverse, boost::dynamic_bitset<> &found) {
+        std::vector<std::size_t> stack;
+        for(auto state = found.find_first(); state != boost::dynamic_bitset<>::npos; state = found.find_next(state)) {
+            stack.push_back(state);
+        }
+        while(!stack.empty()) {
+            std::size_t dest = stack.back();
+            stack.pop_back();
+            for(std::size_t i = reverse.offsets[dest]; i < reverse.offsets[dest + 1]; i++) {
+                if(!found[reverse.sources[i]]) {
+                    found.set(reverse.sources[i]);
+                    stack.push_back(reverse.sources[i]);
+                }
+            }
+        }
+    }
+    
+    // O(n * ALPHABET_SIZE). A state is accepting if it is final, has an arc for every
+    // label and all of them lead to accepting states. Candidates that fail this are
+    // dropped one by one, each drop revisiting only the states with an arc into it.
+    // Dfa is a DAutomaton or a read-only automaton with the same queries, like MappedDAutomaton.
+    template<class Dfa>
+    DecidedStates FindDecidedStates(const Dfa &dfa) {
+        typedef Dfa Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        const StateId numStates = dfa.GetNumStates();
+        const ReverseArcs reverse(numStates, [&](const std::function<void(std::size_t, std::size_t)> &arc) {
+            for(StateId src = 0; src < numStates; src++) {
+                for(Label label = 0; label < Machine::ALPHABET_SIZE; label++) {
+                    StateId dest = dfa.GetNext(src, label);
+                    if(dest != Machine::INVALID_STATE) {
+                        arc(src, dest);
+                    }
+                }
+            }
+        });
+        
+        DecidedStates result;
+        result.dead.resize(numStates);
+        result.accepting.resize(numStates);
+        std::vector<StateId> dropped;
+        for(StateId state = 0; state < numStates; state++) {
+            result.dead[state] = dfa.IsFinal(state);
+            bool complete = dfa.IsFinal(state);
+            for(Label label = 0; label < Machine::ALPHABET_SIZE && complete; label++) {
+                complete = dfa.GetNext(state, label) != Machine::INVALID_STATE;
+            }
+            result.accepting[state] = complete;
+            if(!complete) {
+                dropped.push_back(state);
+            }
+        }
+        
+        // Co-reachable states first, the rest are dead
+        MarkBackwards(reverse, result.dead);
+        result.dead.flip();
+        
+        while(!dropped.empty()) {
+            StateId dest = dropped.back();
+            dropped.pop_back();
+            for(std::size_t i = reverse.offsets[dest]; i < reverse.offsets[dest + 1]; i++) {
+                StateId src = reverse.sources[i];
+                if(result.accepting[src]) {
+                    result.accepting.reset(src);
+                    dropped.push_back(src);
+                }
+            }
+        }
+        return result;
+    }
+    
+    // Dead states are exact, they cannot reach a final state over labelled or epsilon arcs.
+    // Deciding that an NFA state accepts every word is PSPACE-hard, so accepting states are
+    // a safe subset instead: a state is kept while its closure holds a final state and, for
+    // every label, an arc from its closure into another kept state. Each (state, label) counts
+    // such arcs, and dropping a state decrements the counters of the closures that reach it,
+    // so the fixpoint takes O(closures * ALPHABET_SIZE + arcs * closures containing their source).
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    DecidedStates FindDecidedStates(const NAutomaton<ALPHABET_SIZE, StateIdType> &nfa, const EpsilonClosure<NAutomaton<ALPHABET_SIZE, StateIdType> > &closure) {
+        typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        const StateId numStates = nfa.GetNumStates();
+        const ReverseArcs reverse(numStates, [&](const std::function<void(std::size_t, std::size_t)> &arc) {
+            for(StateId src = 0; src < numStates; src++) {
+                for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                    for(auto &next : nfa.GetNext(src, label)) {
+                        arc(src, ArcDestination(next));
+                    }
+                }
+                for(auto &next : nfa.GetEpsilonNext(src)) {
+                    arc(src, next.second);
+                }
+            }
+        });
+        
+        DecidedStates result;
+        result.dead.resize(numStates);
+        result.accepting.resize(numStates);
+        for(StateId state = 0; state < numStates; state++) {
+            result.dead[state] = nfa.IsFinal(state);
+        }
+        MarkBackwards(reverse, result.dead);
+        result.dead.flip();
+        
+        for(StateId state = 0; state < numStates; state++) {
+            for(StateId member : closure.GetClosure(state)) {
+                if(nfa.IsFinal(member)) {
+                    result.accepting.set(state);
+                }
+            }
+        }
+        
+        // Labelled arcs into each state, their sources stored as src * ALPHABET_SIZE + label
+        const ReverseArcs labelledArcs(numStates, [&](const std::function<void(std::size_t, std::size_t)> &arc) {
+            for(StateId src = 0; src < numStates; src++) {
+                for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                    for(auto &next : nfa.GetNext(src, label)) {
+                        arc(static_cast<std::size_t>(src) * ALPHABET_SIZE + label, ArcDestination(next));
+                    }
+                }
+            }
+        });
+        
+        // The states whose closure contains each state
+        const ReverseArcs containedIn(numStates, [&](const std::function<void(std::size_t, std::size_t)> &arc) {
+            for(StateId state = 0; state < numStates; state++) {
+                for(StateId member : closure.GetClosure(state)) {
+                    arc(state, member);
+                }
+            }
+        });
+        
+        // Indexed by state * ALPHABET_SIZE + label
+        std::vector<std::size_t> keptArcs(static_cast<std::size_t>(numStates) * ALPHABET_SIZE, 0);
+        for(StateId state = 0; state < numStates; state++) {
+            for(StateId member : closure.GetClosure(state)) {
+                for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                    for(auto &next : nfa.GetNext(member, label)) {
+                        if(result.accepting[ArcDestination(next)]) {
+                            keptArcs[static_cast<std::size_t>(state) * ALPHABET_SIZE + label]++;
+                        }
+                    }
+                }
+            }
+        }
+        
+        std::vector<StateId> dropped;
+        for(auto state = result.accepting.find_first(); state != boost::dynamic_bitset<>::npos; state = result.accepting.find_next(state)) {
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                if(keptArcs[state * ALPHABET_SIZE + label] == 0) {
+                    dropped.push_back(state);
+                    break;
+                }
+            }
+        }
+        for(StateId state : dropped) {
+            result.accepting.reset(state);
+        }
+        
+        while(!dropped.empty()) {
+            StateId dest = dropped.back();
+            dropped.pop_back();
+            for(std::size_t i = labelledArcs.offsets[dest]; i < labelledArcs.offsets[dest + 1]; i++) {
+                const std::size_t member = labelledArcs.sources[i] / ALPHABET_SIZE;
+                const Label label = labelledArcs.sources[i] % ALPHABET_SIZE;
+                for(std::size_t j = containedIn.offsets[member]; j < containedIn.offsets[member + 1]; j++) {
+                    const std::size_t state = containedIn.sources[j];
+                    if(--keptArcs[state * ALPHABET_SIZE + label] == 0 && result.accepting[state]) {
+                        result.accepting.reset(state);
+                        dropped.push_back(state);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+}
\ No newline at end of file
@@ -1,6 +1,101 @@
 #pragma once
 
 namespace FACore {
+    
+    // The order in which the digits of a number are fed to an automaton
+    enum class DigitOrder {
+        LeastSignificantFirst,
+        MostSignificantFirst
+    };
+    
+    constexpr bool IsPowerOfTwo(unsigned int value) {
+        return value != 0 && (value & (value - 1)) == 0;
+    }
+    
+    constexpr unsigned int FloorLog2(unsigned int value) {
+        return value <= 1 ? 0 : 1 + FloorLog2(value / 2);
+    }
+    
+    // Digit extraction for any unsigned NumberType: builtins, unsigned __int128 or cpp_int.
+    // Power of two alphabets are specialized to shifts and masks, which matters for
+    // types whose division is a library call.
+    template<unsigned int ALPHABET_SIZE, typename NumberType, bool POWER_OF_TWO = IsPowerOfTwo(ALPHABET_SIZE)>
+    struct DigitArithmetic {
+        // Place value of the most significant digit, 0 once every digit was read
+        typedef NumberType Position;
+        
+        static unsigned int LowDigit(const NumberType &value) {
+            return static_cast<unsigned int>(value % ALPHABET_SIZE);
+        }
+        
+        static void DropLowDigit(NumberType &value) {
+            value /= ALPHABET_SIZE;
+        }
+        
+        static Position TopPosition(const NumberType &value) {
+            if(value == 0) {
+                return 0;
+            }
+            NumberType power = 1;
+            while(power <= value / ALPHABET_SIZE) {
+                power *= ALPHABET_SIZE;
+            }
+            return power;
+        }
+        
+        static unsigned int DigitAt(const NumberType &value, const Position &position) {
+            return static_cast<unsigned int>((value / position) % ALPHABET_SIZE);
+        }
+        
+        static void Lower(Position &position) {
+            position /= ALPHABET_SIZE;
+        }
+        
+        static bool IsEnd(const Position &position) {
+            return position == 0;
+        }
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename NumberType>
+    struct DigitArithmetic<ALPHABET_SIZE, NumberType, true> {
+        constexpr static unsigned int BITS = FloorLog2(ALPHABET_SIZE);
+        
+        // Shift of the most significant digit, negative once every digit was read
+        typedef long Position;
+        
+        static unsigned int LowDigit(const NumberType &value) {
+            return static_cast<unsigned int>(value & (ALPHABET_SIZE - 1));
+        }
+        
+        static void DropLowDigit(NumberType &value) {
+            value >>= BITS;
+        }
+        
+        static Position TopPosition(NumberType value) {
+            Position position = -static_cast<Position>(BITS);
+            for(; value != 0; value >>= BITS) {
+                position += BITS;
+            }
+            return position;
+        }
+        
+        static unsigned int DigitAt(const NumberType &value, Position position) {
+            return static_cast<unsigned int>((value >> position) & (ALPHABET_SIZE - 1));
+        }
+        
+        static void Lower(Position &position) {
+            position -= BITS;
+        }
+        
+        static bool IsEnd(Position position) {
+            return position < 0;
+        }
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename NumberType>
+    constexpr unsigned int DigitArithmetic<ALPHABET_SIZE, NumberType, true>::BITS;
+    
+    // Yields the digits of a number least significant first, without leading zeros
     template<
         unsigned int ALPHABET_SIZE,
         typename DigitType = unsigned int,
@@ -11,16 +106,16 @@ namespace FACore {
             static DigitIterator end() {
                 return DigitIterator(0);
             }
-        
+            
             DigitIterator(NumberType value) : mValue(value)
             {}
             
             DigitType operator* () {
-                return mValue % ALPHABET_SIZE;
+                return Arithmetic::LowDigit(mValue);
             }
             
             DigitIterator& operator++() {
-                mValue = mValue / ALPHABET_SIZE;
+                Arithmetic::DropLowDigit(mValue);
                 return *this;
             }
             
@@ -33,6 +128,58 @@ namespace FACore {
             }
         
         private:
+            typedef DigitArithmetic<ALPHABET_SIZE, NumberType> Arithmetic;
+            
             NumberType mValue;
     };
+    
+    // Yields the digits of a number most significant first, without leading zeros
+    template<
+        unsigned int ALPHABET_SIZE,
+        typename DigitType = unsigned int,
+        typename NumberType = unsigned int
+        >
+    class MostSignificantDigitIterator {
+        public:
+            static MostSignificantDigitIterator end() {
+                return MostSignificantDigitIterator(0);
+            }
+            
+            MostSignificantDigitIterator(NumberType value) : mValue(value), mPosition(Arithmetic::TopPosition(mValue))
+            {}
+            
+            DigitType operator* () {
+                return Arithmetic::DigitAt(mValue, mPosition);
+            }
+            
+            MostSignificantDigitIterator& operator++() {
+                Arithmetic::Lower(mPosition);
+                return *this;
+            }
+            
+            // Only compares the remaining digit count, which is what loops up to end() need
+            bool operator==(const MostSignificantDigitIterator &other) {
+                return Arithmetic::IsEnd(mPosition) ? Arithmetic::IsEnd(other.mPosition) : mPosition == other.mPosition;
+            }
+            
+            bool operator!=(const MostSignificantDigitIterator &other) {
+                return !operator==(other);
+            }
+        
+        private:
+            typedef DigitArithmetic<ALPHABET_SIZE, NumberType> Arithmetic;
+            
+            NumberType mValue;
+            typename Arithmetic::Position mPosition;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, DigitOrder ORDER, typename DigitType, typename NumberType>
+    struct DigitIteratorFor {
+        typedef DigitIterator<ALPHABET_SIZE, DigitType, NumberType> type;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename DigitType, typename NumberType>
+    struct DigitIteratorFor<ALPHABET_SIZE, DigitOrder::MostSignificantFirst, DigitType, NumberType> {
+        typedef MostSignificantDigitIterator<ALPHABET_SIZE, DigitType, NumberType> type;
+    };
 }
\ No newline at end of file
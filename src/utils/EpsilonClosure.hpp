@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // The epsilon closure of every state of an NAutomaton, computed once and stored as
+    // compressed sparse rows: the closure of a state is the state itself followed by
+    // every state reachable from it over epsilon arcs. Closing a set of states then
+    // reads these precomputed rows instead of walking the epsilon arcs again.
+    template<class Machine>
+    class EpsilonClosure {
+        public:
+            typedef typename Machine::StateId StateId;
+            typedef boost::dynamic_bitset<> Subset;
+            
+            class StateRange {
+                public:
+                    StateRange(const StateId *begin, const StateId *end) : mBegin(begin), mEnd(end)
+                    {}
+                    
+                    const StateId* begin() const { return mBegin; }
+                    const StateId* end() const { return mEnd; }
+                
+                private:
+                    const StateId *mBegin;
+                    const StateId *mEnd;
+            };
+            
+            // A depth first search from every state, O(n * (n + epsilon arcs)) in the worst case
+            explicit EpsilonClosure(const Machine &automaton) : mTrivial(!automaton.HasEpsilonArcs())
+            {
+                const StateId numStates = automaton.GetNumStates();
+                mOffsets.reserve(static_cast<std::size_t>(numStates) + 1);
+                mOffsets.push_back(0);
+                if(mTrivial) {
+                    for(StateId state = 0; state < numStates; state++) {
+                        mStates.push_back(state);
+                        mOffsets.push_back(mStates.size());
+                    }
+                    return;
+                }
+                
+                // visited[s] == state + 1 once s was added to the closure of state
+                std::vector<std::size_t> visited(numStates, 0);
+                std::vector<StateId> stack;
+                for(StateId state = 0; state < numStates; state++) {
+                    const std::size_t mark = static_cast<std::size_t>(state) + 1;
+                    visited[state] = mark;
+                    mStates.push_back(state);
+                    stack.push_back(state);
+                    while(!stack.empty()) {
+                        StateId src = stack.back();
+                        stack.pop_back();
+                        for(auto &arc : automaton.GetEpsilonNext(src)) {
+                            StateId dest = arc.second;
+                            if(visited[dest] != mark) {
+                                visited[dest] = mark;
+                                mStates.push_back(dest);
+                                stack.push_back(dest);
+                            }
+                        }
+                    }
+                    mOffsets.push_back(mStates.size());
+                }
+            }
+            
+            // Whether the automaton has no epsilon arcs, every closure is then the state alone
+            bool IsTrivial() const {
+                return mTrivial;
+            }
+            
+            StateRange GetClosure(StateId state) const {
+                return StateRange(mStates.data() + mOffsets[state], mStates.data() + mOffsets[state + 1]);
+            }
+            
+            // Adds the closure of every state in subset to it
+            void Close(Subset &subset) const {
+                if(mTrivial) {
+                    return;
+                }
+                // States added along the way are closed already, visiting them again is harmless
+                for(auto state = subset.find_first(); state != Subset::npos; state = subset.find_next(state)) {
+                    for(StateId member : GetClosure(state)) {
+                        subset.set(member);
+                    }
+                }
+            }
+            
+            // Sets the closure of state in subset
+            void Insert(Subset &subset, StateId state) const {
+                for(StateId member : GetClosure(state)) {
+                    subset.set(member);
+                }
+            }
+        
+        private:
+            bool mTrivial;
+            std::vector<std::size_t> mOffsets;
+            std::vector<StateId> mStates;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace FACore {
+    
+    // Instrumentation policies for DRegularLanguage and NRegularLanguage. The language
+    // derives from its policy, so counters live in each language object and are never
+    // shared between threads. Work done only for the counters is guarded by ENABLED,
+    // which lets the compiler drop it, and NoInstrumentation takes no space. Operations that
+    // build a new language give it the policy of their (left) operand, with fresh counters.
+    struct NoInstrumentation {
+        constexpr static bool ENABLED = false;
+        
+        // charactersConsumed were read. stoppedEarly is set whenever the walk stopped before the
+        // end of the input, whether on a dead state, on a decided accepting state, or on
+        // INVALID_STATE after a label outside of the alphabet.
+        void RecordQuery(std::size_t /*charactersConsumed*/, bool /*stoppedEarly*/) {}
+        
+        // Size of the active set after a step, NRegularLanguage only
+        void RecordActiveStates(std::size_t /*activeStates*/) {}
+        
+        // Transitions answered by the lazy DFA cache and transitions it had to compute
+        void RecordCacheLookups(std::size_t /*hits*/, std::size_t /*misses*/) {}
+    };
+    
+    class CountingInstrumentation {
+        public:
+            constexpr static bool ENABLED = true;
+            
+            void RecordQuery(std::size_t charactersConsumed, bool stoppedEarly) {
+                mNumQueries++;
+                mNumCharacters += charactersConsumed;
+                mNumEarlyExits += stoppedEarly;
+            }
+            
+            void RecordActiveStates(std::size_t activeStates) {
+                mPeakActiveStates = std::max<std::uint64_t>(mPeakActiveStates, activeStates);
+            }
+            
+            void RecordCacheLookups(std::size_t hits, std::size_t misses) {
+                mNumCacheHits += hits;
+                mNumCacheMisses += misses;
+            }
+            
+            std::uint64_t GetNumQueries() const {
+                return mNumQueries;
+            }
+            
+            std::uint64_t GetNumCharacters() const {
+                return mNumCharacters;
+            }
+            
+            std::uint64_t GetNumEarlyExits() const {
+                return mNumEarlyExits;
+            }
+            
+            // Largest active set seen since the last Reset
+            std::uint64_t GetPeakActiveStates() const {
+                return mPeakActiveStates;
+            }
+            
+            std::uint64_t GetNumCacheHits() const {
+                return mNumCacheHits;
+            }
+            
+            std::uint64_t GetNumCacheMisses() const {
+                return mNumCacheMisses;
+            }
+            
+            // Zero before the first lookup
+            double GetCacheHitRate() const {
+                const std::uint64_t lookups = mNumCacheHits + mNumCacheMisses;
+                return lookups == 0 ? 0.0 : static_cast<double>(mNumCacheHits) / lookups;
+            }
+            
+            void Reset() {
+                *this = CountingInstrumentation();
+            }
+        
+        private:
+            std::uint64_t mNumQueries = 0;
+            std::uint64_t mNumCharacters = 0;
+            std::uint64_t mNumEarlyExits = 0;
+            std::uint64_t mPeakActiveStates = 0;
+            std::uint64_t mNumCacheHits = 0;
+            std::uint64_t mNumCacheMisses = 0;
+    };
+}
\ No newline at end of file
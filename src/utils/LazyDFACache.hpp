@@ -0,0 +1,211 @@
+#pragma once
+
+#include "../NAutomaton.hpp"
+#include "EpsilonClosure.hpp"
+#include "DecidedStates.hpp"
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <unordered_map>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace FACore {
+    
+    // A DFA built on the fly from an NAutomaton, in the style of RE2's lazy DFA.
+    // Each subset of NFA states is interned the first time it is reached and its
+    // transitions are memoized, so a path that was walked before costs one array
+    // lookup per character. When the estimated memory use would exceed the budget
+    // the whole cache is flushed and rebuilt from the states that are needed next.
+    template<class Machine>
+    class LazyDFACache {
+        public:
+            typedef typename Machine::Label Label;
+            typedef typename Machine::StateId NStateId;
+            typedef boost::dynamic_bitset<> Subset;
+            typedef EpsilonClosure<Machine> Closure;
+            
+            // Index of a cached subset, only valid until the next flush
+            typedef unsigned int StateId;
+            
+            constexpr static unsigned int ALPHABET_SIZE = Machine::ALPHABET_SIZE;
+            
+            // The empty subset, it has no transitions and is never final
+            constexpr static StateId DEAD_STATE = std::numeric_limits<unsigned int>::max();
+            
+            // initialStates must be closed over epsilon arcs already. Dead states are left out of
+            // every subset, so a subset holding only dead states becomes DEAD_STATE.
+            LazyDFACache(const Machine &automaton, std::shared_ptr<const Closure> closure, const Subset &initialStates, std::size_t memoryBudget, const DecidedStates &decided) :
+                mAutomaton(automaton), mClosure(closure), mInitialSubset(initialStates - decided.dead), mFinalSubset(initialStates.size()),
+                mLiveSubset(~decided.dead), mAcceptingSubset(decided.accepting),
+                mMemoryBudget(memoryBudget), mMemoryUsed(0), mNumFlushes(0), mNumMisses(0), mNext(initialStates.size())
+            {
+                for(NStateId state = 0; state < mFinalSubset.size(); state++) {
+                    mFinalSubset[state] = automaton.IsFinal(state);
+                }
+                mInitialState = UNKNOWN_STATE;
+                mInitialState = Intern(mInitialSubset);
+            }
+            
+            StateId GetInitialState() {
+                if(mInitialState == UNKNOWN_STATE) {
+                    mInitialState = Intern(mInitialSubset);
+                }
+                return mInitialState;
+            }
+            
+            // The label must be valid for the automaton
+            StateId GetNext(StateId src, Label label) {
+                if(src == DEAD_STATE) {
+                    return DEAD_STATE;
+                }
+                StateId cached = mTransitions[static_cast<std::size_t>(src) * ALPHABET_SIZE + label];
+                if(cached != UNKNOWN_STATE) {
+                    return cached;
+                }
+                
+                mNumMisses++;
+                const Subset &subset = *mSubsets[src];
+                mNext.reset();
+                for(auto state = subset.find_first(); state != Subset::npos; state = subset.find_next(state)) {
+                    for(auto &arc : mAutomaton.GetNext(state, label)) {
+                        mClosure->Insert(mNext, ArcDestination(arc));
+                    }
+                }
+                
+                mNext &= mLiveSubset;
+                
+                std::size_t flushes = mNumFlushes;
+                StateId next = Intern(mNext);
+                if(flushes == mNumFlushes) {
+                    // Only memoize if src survived
+                    mTransitions[static_cast<std::size_t>(src) * ALPHABET_SIZE + label] = next;
+                }
+                return next;
+            }
+            
+            // Whether state is the initial subset, without interning it again after a flush
+            bool IsInitial(StateId state) const {
+                return state == mInitialState;
+            }
+            
+            bool IsFinal(StateId state) const {
+                return state != DEAD_STATE && mFinalStates[state];
+            }
+            
+            // Every continuation from the state is accepted
+            bool IsAccepting(StateId state) const {
+                return state != DEAD_STATE && mAcceptingStates[state];
+            }
+            
+            StateId GetNumStates() const {
+                return mSubsets.size();
+            }
+            
+            std::size_t GetMemoryUsage() const {
+                return mMemoryUsed;
+            }
+            
+            std::size_t GetMemoryBudget() const {
+                return mMemoryBudget;
+            }
+            
+            std::size_t GetNumFlushes() const {
+                return mNumFlushes;
+            }
+            
+            // Transitions GetNext had to compute rather than read from the cache
+            std::size_t GetNumMisses() const {
+                return mNumMisses;
+            }
+            
+            // The NFA states behind a cached state, which must not be DEAD_STATE
+            const Subset& GetSubset(StateId state) const {
+                return *mSubsets[state];
+            }
+            
+            void Flush() {
+                mSubsetIds.clear();
+                mSubsets.clear();
+                mTransitions.clear();
+                mFinalStates.clear();
+                mAcceptingStates.clear();
+                mMemoryUsed = 0;
+                mInitialState = UNKNOWN_STATE;
+                mNumFlushes++;
+            }
+        
+        private:
+            constexpr static StateId UNKNOWN_STATE = DEAD_STATE - 1;
+            
+            // Rough cost of one cached state: its transition row, its subset
+            // (stored once in the map) and the hash node around it
+            std::size_t StateCost(const Subset &subset) const {
+                return ALPHABET_SIZE * sizeof(StateId) + subset.num_blocks() * sizeof(Subset::block_type) + sizeof(Subset) + 4 * sizeof(void*);
+            }
+            
+            StateId Intern(const Subset &subset) {
+                if(subset.none()) {
+                    return DEAD_STATE;
+                }
+                auto found = mSubsetIds.find(subset);
+                if(found != mSubsetIds.end()) {
+                    return found->second;
+                }
+                
+                // A flush always leaves room for at least one state
+                std::size_t cost = StateCost(subset);
+                if(mMemoryUsed + cost > mMemoryBudget && !mSubsets.empty()) {
+                    Flush();
+                }
+                
+                StateId id = mSubsets.size();
+                auto inserted = mSubsetIds.emplace(subset, id);
+                mSubsets.push_back(&inserted.first->first);
+                mTransitions.resize(mTransitions.size() + ALPHABET_SIZE, UNKNOWN_STATE);
+                if(mInitialState == UNKNOWN_STATE && subset == mInitialSubset) {
+                    mInitialState = id;
+                }
+                mFinalStates.push_back(subset.intersects(mFinalSubset));
+                mAcceptingStates.push_back(subset.intersects(mAcceptingSubset));
+                mMemoryUsed += cost;
+                return id;
+            }
+            
+            const Machine &mAutomaton;
+            std::shared_ptr<const Closure> mClosure;
+            Subset mInitialSubset;
+            Subset mFinalSubset;
+            Subset mLiveSubset;
+            Subset mAcceptingSubset;
+            StateId mInitialState;
+            
+            std::size_t mMemoryBudget;
+            std::size_t mMemoryUsed;
+            std::size_t mNumFlushes;
+            std::size_t mNumMisses;
+            
+            // The map owns the subsets, node addresses are stable across rehashing
+            std::unordered_map<Subset, StateId, boost::hash<Subset> > mSubsetIds;
+            std::vector<const Subset*> mSubsets;
+            
+            // Indexed by state * ALPHABET_SIZE + label
+            std::vector<StateId> mTransitions;
+            boost::dynamic_bitset<> mFinalStates;
+            boost::dynamic_bitset<> mAcceptingStates;
+            
+            // Scratch space for computing successor subsets
+            Subset mNext;
+    };
+    
+    template<class Machine>
+    constexpr unsigned int LazyDFACache<Machine>::ALPHABET_SIZE;
+    
+    template<class Machine>
+    constexpr typename LazyDFACache<Machine>::StateId LazyDFACache<Machine>::DEAD_STATE;
+    
+    template<class Machine>
+    constexpr typename LazyDFACache<Machine>::StateId LazyDFACache<Machine>::UNKNOWN_STATE;
+}
\ No newline at end of file
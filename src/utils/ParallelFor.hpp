@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <exception>
+#include <algorithm>
+
+namespace FACore {
+    
+    // Zero asks for one thread per hardware thread
+    inline unsigned int ResolveThreadCount(unsigned int numThreads) {
+        if(numThreads == 0) {
+            numThreads = std::thread::hardware_concurrency();
+        }
+        return std::max(numThreads, 1u);
+    }
+    
+    // Calls body(begin, end, thread) over [0, count) in chunks of at most chunkSize indices,
+    // from numThreads threads including the calling one. Chunks are claimed from a shared
+    // counter, so a thread that finishes early keeps taking work instead of idling behind
+    // a fixed split. thread is in [0, numThreads), for per-thread scratch space. The first
+    // exception thrown by body stops the remaining chunks and is rethrown here.
+    template<class Body>
+    void ParallelFor(std::size_t count, unsigned int numThreads, std::size_t chunkSize, Body body) {
+        numThreads = static_cast<unsigned int>(std::min<std::size_t>(ResolveThreadCount(numThreads), (count + chunkSize - 1) / chunkSize));
+        if(numThreads <= 1) {
+            for(std::size_t begin = 0; begin < count; begin += chunkSize) {
+                body(begin, std::min(count, begin + chunkSize), 0u);
+            }
+            return;
+        }
+        
+        std::atomic<std::size_t> next(0);
+        std::atomic<bool> failed(false);
+        std::exception_ptr error;
+        auto work = [&](unsigned int thread) {
+            try {
+                while(!failed.load(std::memory_order_relaxed)) {
+                    std::size_t begin = next.fetch_add(chunkSize, std::memory_order_relaxed);
+                    if(begin >= count) {
+                        break;
+                    }
+                    body(begin, std::min(count, begin + chunkSize), thread);
+                }
+            } catch(...) {
+                if(!failed.exchange(true)) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for(unsigned int thread = 1; thread < numThreads; thread++) {
+            threads.emplace_back(work, thread);
+        }
+        work(0);
+        for(std::thread &thread : threads) {
+            thread.join();
+        }
+        if(error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "../DAutomaton.hpp"
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cstddef>
+#include <type_traits>
+
+namespace FACore {
+    
+    // The states of a DFA reachable from a valid initial state, numbered densely in BFS order
+    // with the initial state as 0. The index after the last of them is a sink standing in for
+    // INVALID_STATE, which loops on every label.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    class CompletedReachableStates {
+        public:
+            typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+            typedef typename Machine::StateId StateId;
+            typedef typename Machine::Label Label;
+            
+            // Internal indices, wide enough for the extra sink state
+            typedef typename std::common_type<StateId, unsigned int>::type Index;
+            
+            CompletedReachableStates(const Machine &dfa, StateId initialState) : mDfa(dfa), mDense(dfa.GetNumStates(), UNSEEN)
+            {
+                mDense[initialState] = 0;
+                mOriginal.push_back(initialState);
+                for(Index current = 0; current < mOriginal.size(); current++) {
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        StateId next = dfa.GetNext(mOriginal[current], label);
+                        if(next != Machine::INVALID_STATE && mDense[next] == UNSEEN) {
+                            mDense[next] = mOriginal.size();
+                            mOriginal.push_back(next);
+                        }
+                    }
+                }
+            }
+            
+            Index GetNumReachable() const {
+                return mOriginal.size();
+            }
+            
+            Index GetSink() const {
+                return mOriginal.size();
+            }
+            
+            // The reachable states and the sink
+            Index GetNumStates() const {
+                return mOriginal.size() + 1;
+            }
+            
+            Index GetNext(Index state, Label label) const {
+                if(state == GetSink()) {
+                    return state;
+                }
+                StateId next = mDfa.GetNext(mOriginal[state], label);
+                return next == Machine::INVALID_STATE ? GetSink() : mDense[next];
+            }
+            
+            bool IsFinal(Index state) const {
+                return state != GetSink() && mDfa.IsFinal(mOriginal[state]);
+            }
+        
+        private:
+            constexpr static Index UNSEEN = std::numeric_limits<Index>::max();
+            
+            const Machine &mDfa;
+            std::vector<Index> mDense;
+            std::vector<Index> mOriginal;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    constexpr typename CompletedReachableStates<ALPHABET_SIZE, StateIdType>::Index CompletedReachableStates<ALPHABET_SIZE, StateIdType>::UNSEEN;
+    
+    // Sources of the arcs into each state, per label, in compressed sparse rows.
+    // Every state has exactly one arc per label, given by next(state, label).
+    template<unsigned int ALPHABET_SIZE, typename Index>
+    class InverseTransitions {
+        public:
+            typedef unsigned int Label;
+            
+            template<class Next>
+            InverseTransitions(Index numStates, Next next) : mNumStates(numStates), mOffsets(static_cast<std::size_t>(ALPHABET_SIZE) * numStates + 1, 0), mSources(static_cast<std::size_t>(ALPHABET_SIZE) * numStates)
+            {
+                for(Index state = 0; state < numStates; state++) {
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        mOffsets[Row(label, next(state, label)) + 1]++;
+                    }
+                }
+                for(std::size_t i = 1; i < mOffsets.size(); i++) {
+                    mOffsets[i] += mOffsets[i - 1];
+                }
+                std::vector<std::size_t> fill(mOffsets.begin(), mOffsets.end() - 1);
+                for(Index state = 0; state < numStates; state++) {
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        mSources[fill[Row(label, next(state, label))]++] = state;
+                    }
+                }
+            }
+            
+            // The states with a label-arc into dest, in increasing order
+            const Index* SourcesBegin(Index dest, Label label) const {
+                return mSources.data() + mOffsets[Row(label, dest)];
+            }
+            
+            const Index* SourcesEnd(Index dest, Label label) const {
+                return mSources.data() + mOffsets[Row(label, dest) + 1];
+            }
+        
+        private:
+            std::size_t Row(Label label, Index dest) const {
+                return static_cast<std::size_t>(label) * mNumStates + dest;
+            }
+            
+            Index mNumStates;
+            std::vector<std::size_t> mOffsets;
+            std::vector<Index> mSources;
+    };
+    
+    // Hopcroft's refinable partition together with its worklist of (block, label) splitters.
+    // Each block is a contiguous range of elements, marked states are swapped to the front
+    // of their block until SplitMarked splits them off.
+    template<unsigned int ALPHABET_SIZE, typename Index>
+    class HopcroftPartition {
+        public:
+            typedef unsigned int Label;
+            typedef std::pair<Index, Label> Splitter;
+            
+            // Final and non-final states start out in separate blocks, the smaller one is queued for every label
+            template<class IsFinal>
+            HopcroftPartition(Index numStates, IsFinal isFinal) : mElements(numStates), mLocation(numStates), mBlockOf(numStates)
+            {
+                Index front = 0;
+                for(int pass = 0; pass < 2; pass++) {
+                    Index start = front;
+                    for(Index state = 0; state < numStates; state++) {
+                        if(isFinal(state) == (pass == 0)) {
+                            mElements[front] = state;
+                            mLocation[state] = front;
+                            mBlockOf[state] = mBlockStart.size();
+                            front++;
+                        }
+                    }
+                    if(front != start) {
+                        mBlockStart.push_back(start);
+                        mBlockEnd.push_back(front);
+                        mBlockMarked.push_back(0);
+                    }
+                }
+                
+                if(mBlockStart.size() == 2) {
+                    Index smaller = GetBlockSize(0) <= GetBlockSize(1) ? 0 : 1;
+                    for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                        AddSplitter(smaller, label);
+                    }
+                }
+            }
+            
+            bool HasSplitters() const {
+                return !mWorklist.empty();
+            }
+            
+            Splitter PopSplitter() {
+                Splitter splitter = mWorklist.back();
+                mWorklist.pop_back();
+                mInWorklist[splitter.first * ALPHABET_SIZE + splitter.second] = false;
+                return splitter;
+            }
+            
+            // Moves every pending splitter into round, most recently queued first as PopSplitter would
+            void TakeSplitters(std::vector<Splitter> &round) {
+                round.assign(mWorklist.rbegin(), mWorklist.rend());
+                mWorklist.clear();
+                for(const Splitter &splitter : round) {
+                    mInWorklist[splitter.first * ALPHABET_SIZE + splitter.second] = false;
+                }
+            }
+            
+            Index GetNumBlocks() const {
+                return mBlockStart.size();
+            }
+            
+            Index GetBlock(Index state) const {
+                return mBlockOf[state];
+            }
+            
+            Index GetBlockSize(Index block) const {
+                return mBlockEnd[block] - mBlockStart[block];
+            }
+            
+            // The states of a block, reordered by Mark
+            const Index* BlockBegin(Index block) const {
+                return mElements.data() + mBlockStart[block];
+            }
+            
+            const Index* BlockEnd(Index block) const {
+                return mElements.data() + mBlockEnd[block];
+            }
+            
+            void Mark(Index state) {
+                Index block = mBlockOf[state];
+                Index markedEnd = mBlockStart[block] + mBlockMarked[block];
+                if(mLocation[state] < markedEnd) {
+                    return;
+                }
+                if(mBlockMarked[block] == 0) {
+                    mTouched.push_back(block);
+                }
+                Index other = mElements[markedEnd];
+                std::swap(mElements[mLocation[state]], mElements[markedEnd]);
+                mLocation[other] = mLocation[state];
+                mLocation[state] = markedEnd;
+                mBlockMarked[block]++;
+            }
+            
+            // Splits each block with marked and unmarked states, relabelling the smaller half.
+            // A pending splitter of the old block stays pending for both halves, otherwise
+            // only the smaller half has to be queued.
+            void SplitMarked() {
+                for(Index splitBlock : mTouched) {
+                    Index marked = mBlockMarked[splitBlock];
+                    Index size = GetBlockSize(splitBlock);
+                    mBlockMarked[splitBlock] = 0;
+                    if(marked == size) {
+                        continue;
+                    }
+                    
+                    Index newBlock = mBlockStart.size();
+                    if(marked <= size - marked) {
+                        mBlockStart.push_back(mBlockStart[splitBlock]);
+                        mBlockEnd.push_back(mBlockStart[splitBlock] + marked);
+                        mBlockStart[splitBlock] += marked;
+                    } else {
+                        mBlockStart.push_back(mBlockStart[splitBlock] + marked);
+                        mBlockEnd.push_back(mBlockEnd[splitBlock]);
+                        mBlockEnd[splitBlock] = mBlockStart[splitBlock] + marked;
+                    }
+                    mBlockMarked.push_back(0);
+                    for(Index i = mBlockStart[newBlock]; i < mBlockEnd[newBlock]; i++) {
+                        mBlockOf[mElements[i]] = newBlock;
+                    }
+                    
+                    for(Label c = 0; c < ALPHABET_SIZE; c++) {
+                        bool pending = mInWorklist.size() > splitBlock * ALPHABET_SIZE + c && mInWorklist[splitBlock * ALPHABET_SIZE + c];
+                        if(pending) {
+                            AddSplitter(newBlock, c);
+                        } else {
+                            AddSplitter(GetBlockSize(splitBlock) <= GetBlockSize(newBlock) ? splitBlock : newBlock, c);
+                        }
+                    }
+                }
+                mTouched.clear();
+            }
+        
+        private:
+            void AddSplitter(Index block, Label label) {
+                if(mInWorklist.size() <= block * ALPHABET_SIZE + label) {
+                    mInWorklist.resize((block + 1) * ALPHABET_SIZE, false);
+                }
+                if(!mInWorklist[block * ALPHABET_SIZE + label]) {
+                    mInWorklist[block * ALPHABET_SIZE + label] = true;
+                    mWorklist.emplace_back(block, label);
+                }
+            }
+            
+            std::vector<Index> mElements;
+            std::vector<Index> mLocation;
+            std::vector<Index> mBlockOf;
+            std::vector<Index> mBlockStart;
+            std::vector<Index> mBlockEnd;
+            std::vector<Index> mBlockMarked;
+            std::vector<Index> mTouched;
+            
+            std::vector<bool> mInWorklist;
+            std::vector<Splitter> mWorklist;
+    };
+    
+    // Adds a state to the empty automaton for each block of the finished partition that the
+    // initial state 0 reaches, in BFS order, and returns the new initial state. The block of the sink
+    // becomes INVALID_STATE, so nothing is added when the initial state falls into it.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType, typename Index, class Next>
+    typename DAutomaton<ALPHABET_SIZE, StateIdType>::StateId BuildQuotient(const HopcroftPartition<ALPHABET_SIZE, Index> &partition, const CompletedReachableStates<ALPHABET_SIZE, StateIdType> &states, Next next, DAutomaton<ALPHABET_SIZE, StateIdType> &automaton) {
+        typedef DAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+        typedef typename Machine::StateId StateId;
+        typedef typename Machine::Label Label;
+        
+        const Index deadBlock = partition.GetBlock(states.GetSink());
+        std::vector<StateId> blockIds(partition.GetNumBlocks(), Machine::INVALID_STATE);
+        std::vector<Index> representatives;
+        auto intern = [&](Index state) -> StateId {
+            Index block = partition.GetBlock(state);
+            if(block == deadBlock) {
+                return Machine::INVALID_STATE;
+            }
+            if(blockIds[block] == Machine::INVALID_STATE) {
+                blockIds[block] = automaton.AddState(states.IsFinal(state));
+                representatives.push_back(state);
+            }
+            return blockIds[block];
+        };
+        
+        StateId initialState = intern(0);
+        for(Index current = 0; current < representatives.size(); current++) {
+            for(Label label = 0; label < ALPHABET_SIZE; label++) {
+                StateId dest = intern(next(representatives[current], label));
+                if(dest != Machine::INVALID_STATE) {
+                    automaton.SetArc(current, label, dest);
+                }
+            }
+        }
+        return initialState;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <bitset>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+
+namespace FACore {
+    
+    // Bounds of {m,n} above this are rejected, every repetition is expanded into copies
+    constexpr unsigned int REGEX_MAX_REPETITION = 1000;
+    
+    // Patterns whose syntax tree, with every repetition expanded, has more nodes are rejected.
+    // Nested bounds multiply, so this caps the automaton of (0{1000}){1000} as well.
+    constexpr std::size_t REGEX_MAX_EXPANDED_SIZE = 100000;
+    
+    // Groups and operators nested deeper than this are rejected, parsing and building recurse per level
+    constexpr std::size_t REGEX_MAX_DEPTH = 1000;
+    
+    // Parses a regular expression over the labels 0 .. ALPHABET_SIZE-1 into a syntax tree.
+    //   0-9, a-z   the labels 0 to 35
+    //   <n>        label n, in decimal, for any alphabet size
+    //   .          any label
+    //   [...]      a class of labels and ranges such as [0-3<17>], [^...] for its complement
+    //   xy, x|y    concatenation and alternation, an empty branch matches the empty word
+    //   x* x+ x?   Kleene star, plus and optional
+    //   x{m} x{m,} x{m,n}  bounded repetition
+    //   (x)        grouping
+    // Errors are reported as std::invalid_argument with the position in the pattern.
+    template<unsigned int ALPHABET_SIZE>
+    class RegexParser {
+        public:
+            typedef std::bitset<ALPHABET_SIZE> LabelSet;
+            
+            enum class NodeKind {
+                Labels,
+                Concatenation,
+                Alternation,
+                Star,
+                Plus,
+                Optional,
+                Repetition
+            };
+            
+            // Nodes refer to their children by index, a concatenation without children is the empty word
+            struct Node {
+                NodeKind kind;
+                LabelSet labels;
+                std::vector<std::size_t> children;
+                unsigned int minCount;
+                unsigned int maxCount;
+                bool unbounded;
+                
+                // Nodes below and including this one, counting each copy of a repetition
+                std::size_t expandedSize;
+                std::size_t depth;
+            };
+            
+            explicit RegexParser(const std::string &pattern) : mPattern(pattern), mPosition(0), mNesting(0)
+            {
+                mRoot = ParseAlternation();
+                if(!AtEnd()) {
+                    Fail("Unbalanced ')'");
+                }
+            }
+            
+            const std::vector<Node>& GetNodes() const {
+                return mNodes;
+            }
+            
+            std::size_t GetRoot() const {
+                return mRoot;
+            }
+        
+        private:
+            std::size_t ParseAlternation() {
+                std::vector<std::size_t> branches(1, ParseConcatenation());
+                while(Accept('|')) {
+                    branches.push_back(ParseConcatenation());
+                }
+                return branches.size() == 1 ? branches.front() : AddNode(NodeKind::Alternation, branches);
+            }
+            
+            std::size_t ParseConcatenation() {
+                std::vector<std::size_t> items;
+                while(!AtEnd() && Peek() != '|' && Peek() != ')') {
+                    items.push_back(ParseRepetition());
+                }
+                return items.size() == 1 ? items.front() : AddNode(NodeKind::Concatenation, items);
+            }
+            
+            std::size_t ParseRepetition() {
+                std::size_t node = ParseAtom();
+                while(!AtEnd()) {
+                    if(Accept('*')) {
+                        node = AddNode(NodeKind::Star, {node});
+                    } else if(Accept('+')) {
+                        node = AddNode(NodeKind::Plus, {node});
+                    } else if(Accept('?')) {
+                        node = AddNode(NodeKind::Optional, {node});
+                    } else if(Accept('{')) {
+                        node = ParseBounds(node);
+                    } else {
+                        break;
+                    }
+                }
+                return node;
+            }
+            
+            std::size_t ParseBounds(std::size_t child) {
+                Node node = MakeNode(NodeKind::Repetition, {child});
+                node.minCount = ParseCount();
+                node.maxCount = node.minCount;
+                if(Accept(',')) {
+                    if(!AtEnd() && Peek() == '}') {
+                        node.unbounded = true;
+                    } else {
+                        node.maxCount = ParseCount();
+                    }
+                }
+                Expect('}');
+                if(node.maxCount < node.minCount) {
+                    Fail("Repetition bounds out of order");
+                }
+                return PushNode(node);
+            }
+            
+            unsigned int ParseCount() {
+                if(AtEnd() || !IsDecimal(Peek())) {
+                    Fail("Expected a repetition count");
+                }
+                unsigned int count = 0;
+                while(!AtEnd() && IsDecimal(Peek())) {
+                    count = count * 10 + (mPattern[mPosition++] - '0');
+                    if(count > REGEX_MAX_REPETITION) {
+                        Fail("Repetition count too large");
+                    }
+                }
+                return count;
+            }
+            
+            std::size_t ParseAtom() {
+                if(AtEnd()) {
+                    Fail("Expected a label");
+                }
+                if(Accept('(')) {
+                    if(++mNesting > REGEX_MAX_DEPTH) {
+                        Fail("Groups nested too deeply");
+                    }
+                    std::size_t node = ParseAlternation();
+                    Expect(')');
+                    mNesting--;
+                    return node;
+                }
+                Node node = MakeNode(NodeKind::Labels, {});
+                if(Accept('.')) {
+                    node.labels.set();
+                } else if(Accept('[')) {
+                    node.labels = ParseClass();
+                } else {
+                    node.labels.set(ParseLabel());
+                }
+                return PushNode(node);
+            }
+            
+            LabelSet ParseClass() {
+                LabelSet labels;
+                bool complement = Accept('^');
+                while(!Accept(']')) {
+                    if(AtEnd()) {
+                        Fail("Unterminated class");
+                    }
+                    unsigned int low = ParseLabel();
+                    unsigned int high = low;
+                    if(Accept('-')) {
+                        high = ParseLabel();
+                    }
+                    if(high < low) {
+                        Fail("Class range out of order");
+                    }
+                    for(unsigned int label = low; label <= high; label++) {
+                        labels.set(label);
+                    }
+                }
+                return complement ? ~labels : labels;
+            }
+            
+            unsigned int ParseLabel() {
+                if(AtEnd()) {
+                    Fail("Expected a label");
+                }
+                char symbol = Peek();
+                unsigned int label;
+                if(Accept('<')) {
+                    if(AtEnd() || !IsDecimal(Peek())) {
+                        Fail("Expected a decimal label");
+                    }
+                    label = 0;
+                    while(!AtEnd() && IsDecimal(Peek())) {
+                        label = label * 10 + (mPattern[mPosition++] - '0');
+                        if(label >= ALPHABET_SIZE) {
+                            Fail("Label out of range");
+                        }
+                    }
+                    Expect('>');
+                    return label;
+                } else if(IsDecimal(symbol)) {
+                    label = symbol - '0';
+                } else if('a' <= symbol && symbol <= 'z') {
+                    label = symbol - 'a' + 10;
+                } else {
+                    Fail("Expected a label");
+                }
+                if(label >= ALPHABET_SIZE) {
+                    Fail("Label out of range");
+                }
+                mPosition++;
+                return label;
+            }
+            
+            static bool IsDecimal(char symbol) {
+                return '0' <= symbol && symbol <= '9';
+            }
+            
+            bool AtEnd() const {
+                return mPosition == mPattern.size();
+            }
+            
+            char Peek() const {
+                return mPattern[mPosition];
+            }
+            
+            bool Accept(char symbol) {
+                if(!AtEnd() && Peek() == symbol) {
+                    mPosition++;
+                    return true;
+                }
+                return false;
+            }
+            
+            void Expect(char symbol) {
+                if(!Accept(symbol)) {
+                    Fail(std::string("Expected '") + symbol + "'");
+                }
+            }
+            
+            [[noreturn]] void Fail(const std::string &message) const {
+                throw std::invalid_argument(message + " at position " + std::to_string(mPosition) + " of regex \"" + mPattern + "\"");
+            }
+            
+            static Node MakeNode(NodeKind kind, const std::vector<std::size_t> &children) {
+                return Node {kind, LabelSet(), children, 0, 0, false, 0, 0};
+            }
+            
+            std::size_t AddNode(NodeKind kind, const std::vector<std::size_t> &children) {
+                return PushNode(MakeNode(kind, children));
+            }
+            
+            // Children are at most REGEX_MAX_EXPANDED_SIZE each and a repetition makes at most
+            // REGEX_MAX_REPETITION + 1 copies, so the sizes cannot overflow before they are checked
+            std::size_t PushNode(Node node) {
+                std::size_t childrenSize = 0;
+                std::size_t childrenDepth = 0;
+                for(std::size_t child : node.children) {
+                    childrenSize += mNodes[child].expandedSize;
+                    childrenDepth = std::max(childrenDepth, mNodes[child].depth);
+                }
+                if(node.kind == NodeKind::Repetition) {
+                    childrenSize *= node.unbounded ? node.minCount + 1 : node.maxCount;
+                }
+                node.expandedSize = 1 + childrenSize;
+                node.depth = 1 + childrenDepth;
+                if(node.expandedSize > REGEX_MAX_EXPANDED_SIZE) {
+                    Fail("Pattern too large once repetitions are expanded");
+                }
+                if(node.depth > REGEX_MAX_DEPTH) {
+                    Fail("Operators nested too deeply");
+                }
+                mNodes.push_back(node);
+                return mNodes.size() - 1;
+            }
+            
+            const std::string &mPattern;
+            std::size_t mPosition;
+            std::size_t mNesting;
+            std::vector<Node> mNodes;
+            std::size_t mRoot;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "../DAutomaton.hpp"
+#include "../NAutomaton.hpp"
+#include "../NAutomatonBuilder.hpp"
+#include "EpsilonClosure.hpp"
+#include "DecidedStates.hpp"
+#include "LazyDFACache.hpp"
+
+#include <set>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace FACore {
+    
+    // Unanchored search for a language L over a long input. The automaton of L gets an
+    // extra start state that loops on every label and has an epsilon arc to the initial
+    // states, so it accepts every input that ends with a word of L. That automaton is
+    // determinized lazily in a LazyDFACache and read in a single pass, reporting each
+    // offset at which a final state is reached. Labels that leave the start subset
+    // unchanged are found up front, so long stretches of them are skipped with one
+    // table test per character and no cache lookups.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType = unsigned int>
+    class Scanner {
+        public:
+            typedef NAutomaton<ALPHABET_SIZE, StateIdType> Machine;
+            
+            typedef typename Machine::Label Character;
+            typedef typename Machine::StateId StateId;
+            
+            typedef LazyDFACache<Machine> Cache;
+            typedef EpsilonClosure<Machine> Closure;
+            
+            // Memory budget of the lazy DFA, in bytes
+            constexpr static std::size_t DEFAULT_CACHE_BUDGET = 1 << 20;
+            
+            // Dfa is a DAutomaton or a read-only automaton with the same queries, like MappedDAutomaton
+            template<class Dfa, typename = typename std::enable_if<!std::is_same<Dfa, Machine>::value>::type>
+            Scanner(const Dfa &dfa, StateId initialState, std::size_t cacheBudget = DEFAULT_CACHE_BUDGET) {
+                NAutomatonBuilder<ALPHABET_SIZE, StateIdType> builder;
+                for(StateId state = 0; state < dfa.GetNumStates(); state++) {
+                    builder.AddState(dfa.IsFinal(state));
+                }
+                for(StateId state = 0; state < dfa.GetNumStates(); state++) {
+                    for(Character label = 0; label < ALPHABET_SIZE; label++) {
+                        StateId next = dfa.GetNext(state, label);
+                        if(next != Dfa::INVALID_STATE) {
+                            builder.AddArc(state, label, next);
+                        }
+                    }
+                }
+                Build(builder, dfa.IsValidState(initialState) ? std::set<StateId>{initialState} : std::set<StateId>(), cacheBudget);
+            }
+            
+            Scanner(const Machine &nfa, const std::set<StateId> &initialStates, std::size_t cacheBudget = DEFAULT_CACHE_BUDGET) {
+                NAutomatonBuilder<ALPHABET_SIZE, StateIdType> builder;
+                for(StateId state = 0; state < nfa.GetNumStates(); state++) {
+                    builder.AddState(nfa.IsFinal(state));
+                }
+                for(StateId state = 0; state < nfa.GetNumStates(); state++) {
+                    for(Character label = 0; label < ALPHABET_SIZE; label++) {
+                        for(auto &arc : nfa.GetNext(state, label)) {
+                            builder.AddArc(state, label, ArcDestination(arc));
+                        }
+                    }
+                    for(auto &arc : nfa.GetEpsilonNext(state)) {
+                        builder.AddEpsilonArc(state, arc.second);
+                    }
+                }
+                std::set<StateId> validStates;
+                for(StateId state : initialStates) {
+                    if(nfa.IsValidState(state)) {
+                        validStates.insert(state);
+                    }
+                }
+                Build(builder, validStates, cacheBudget);
+            }
+            
+            // Calls callback(offset) for every offset in [0, end - begin] at which a word of the
+            // language ends, in increasing order. Labels outside the alphabet end every match in
+            // progress, the search starts over after them.
+            template<typename IterType, class Callback>
+            void scan(IterType begin, IterType end, Callback callback) {
+                typename Cache::StateId currentState = mCache->GetInitialState();
+                if(currentState == Cache::DEAD_STATE) {
+                    return;
+                }
+                if(mCache->IsFinal(currentState)) {
+                    callback(static_cast<std::size_t>(0));
+                }
+                
+                std::size_t offset = 0;
+                auto iter = begin;
+                while(iter != end) {
+                    if(mCache->IsInitial(currentState)) {
+                        while(iter != end && StaysAtStart(*iter)) {
+                            ++iter;
+                            ++offset;
+                        }
+                        if(iter == end) {
+                            break;
+                        }
+                    }
+                    
+                    Character c = *iter;
+                    ++iter;
+                    ++offset;
+                    if(mAutomaton->IsValidLabel(c)) {
+                        currentState = mCache->GetNext(currentState, c);
+                    } else {
+                        currentState = mCache->GetInitialState();
+                    }
+                    if(mCache->IsFinal(currentState)) {
+                        callback(offset);
+                    }
+                }
+            }
+            
+            const Cache& GetCache() const {
+                return *mCache;
+            }
+        
+        private:
+            typedef boost::dynamic_bitset<> Subset;
+            
+            void Build(NAutomatonBuilder<ALPHABET_SIZE, StateIdType> &builder, const std::set<StateId> &initialStates, std::size_t cacheBudget) {
+                StateId start = builder.AddState(false);
+                for(Character label = 0; label < ALPHABET_SIZE; label++) {
+                    builder.AddArc(start, label, start);
+                }
+                for(StateId state : initialStates) {
+                    builder.AddEpsilonArc(start, state);
+                }
+                mAutomaton.reset(new Machine(builder.Freeze()));
+                
+                std::shared_ptr<const Closure> closure(new Closure(*mAutomaton));
+                const DecidedStates decided = FindDecidedStates(*mAutomaton, *closure);
+                Subset startSubset(mAutomaton->GetNumStates());
+                closure->Insert(startSubset, start);
+                startSubset -= decided.dead;
+                mCache.reset(new Cache(*mAutomaton, closure, startSubset, cacheBudget, decided));
+                
+                // A label stays at the start when it leads from the start subset back into it.
+                // Skipping would hide matches if the start subset were final.
+                mStaysAtStart.resize(ALPHABET_SIZE);
+                if(startSubset.none() || mCache->IsFinal(mCache->GetInitialState())) {
+                    return;
+                }
+                Subset next(mAutomaton->GetNumStates());
+                for(Character label = 0; label < ALPHABET_SIZE; label++) {
+                    next.reset();
+                    for(auto state = startSubset.find_first(); state != Subset::npos; state = startSubset.find_next(state)) {
+                        for(auto &arc : mAutomaton->GetNext(state, label)) {
+                            closure->Insert(next, ArcDestination(arc));
+                        }
+                    }
+                    next -= decided.dead;
+                    mStaysAtStart[label] = next == startSubset;
+                }
+            }
+            
+            // Labels outside the alphabet restart the search, which is staying at the start too
+            bool StaysAtStart(Character c) const {
+                return c >= ALPHABET_SIZE || mStaysAtStart[c];
+            }
+            
+            std::shared_ptr<const Machine> mAutomaton;
+            std::unique_ptr<Cache> mCache;
+            
+            // Indexed by Label
+            boost::dynamic_bitset<> mStaysAtStart;
+    };
+    
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    constexpr std::size_t Scanner<ALPHABET_SIZE, StateIdType>::DEFAULT_CACHE_BUDGET;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../NAutomaton.hpp"
+#include "../DAutomaton.hpp"
+#include "EpsilonClosure.hpp"
+
+#include <set>
+#include <vector>
+#include <unordered_map>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace FACore {
+    
+    // The states of a subset construction. Each DFA state is a set of NFA states closed over
+    // epsilon arcs, stored as a bitset over the NFA states so that interning a subset is a
+    // single hash of its blocks. Interned subsets become states of the given automaton,
+    // numbered in the order they are first interned.
+    template<unsigned int ALPHABET_SIZE, typename StateIdType>
+    class SubsetStates {
+        public:
+            typedef NAutomaton<ALPHABET_SIZE, StateIdType> NMachine;
+            typedef DAutomaton<ALPHABET_SIZE, StateIdType> DMachine;
+            typedef typename NMachine::StateId NStateId;
+            typedef typename DMachine::StateId DStateId;
+            typedef typename DMachine::Label Label;
+            typedef boost::dynamic_bitset<> Subset;
+            
+            // The closures are computed once up front
+            SubsetStates(const NMachine &nfa, DMachine &automaton) : mNfa(nfa), mAutomaton(automaton), mClosure(nfa), mFinalStates(nfa.GetNumStates())
+            {
+                for(NStateId state = 0; state < nfa.GetNumStates(); state++) {
+                    if(nfa.IsFinal(state)) {
+                        mFinalStates.set(state);
+                    }
+                }
+            }
+            
+            // The closure of the valid states among initialStates, empty if there are none
+            Subset GetInitialSubset(const std::set<NStateId> &initialStates) const {
+                Subset initial(mNfa.GetNumStates());
+                for(NStateId state : initialStates) {
+                    if(mNfa.IsValidState(state)) {
+                        mClosure.Insert(initial, state);
+                    }
+                }
+                return initial;
+            }
+            
+            // Replaces next with the closed set of states that subset reaches on label
+            void GetSuccessors(const Subset &subset, Label label, Subset &next) const {
+                next.reset();
+                for(auto src = subset.find_first(); src != Subset::npos; src = subset.find_next(src)) {
+                    for(auto &arc : mNfa.GetNext(src, label)) {
+                        mClosure.Insert(next, ArcDestination(arc));
+                    }
+                }
+            }
+            
+            // The id of subset, which becomes a new state of the automaton if it was not interned before
+            DStateId Intern(const Subset &subset) {
+                auto found = mSubsetIds.find(subset);
+                if(found != mSubsetIds.end()) {
+                    return found->second;
+                }
+                DStateId id = mAutomaton.AddState(subset.intersects(mFinalStates));
+                auto inserted = mSubsetIds.emplace(subset, id);
+                mSubsets.push_back(&inserted.first->first);
+                return id;
+            }
+            
+            // The id of subset, or INVALID_STATE if it was not interned yet. Any number of threads
+            // may look up subsets at once, as long as none is interned meanwhile.
+            DStateId Find(const Subset &subset) const {
+                auto found = mSubsetIds.find(subset);
+                return found == mSubsetIds.end() ? DMachine::INVALID_STATE : found->second;
+            }
+            
+            std::size_t GetNumSubsets() const {
+                return mSubsets.size();
+            }
+            
+            const Subset& GetSubset(DStateId id) const {
+                return *mSubsets[id];
+            }
+        
+        private:
+            const NMachine &mNfa;
+            DMachine &mAutomaton;
+            const EpsilonClosure<NMachine> mClosure;
+            Subset mFinalStates;
+            
+            // The map owns the subsets, node addresses are stable across rehashing
+            std::unordered_map<Subset, DStateId, boost::hash<Subset> > mSubsetIds;
+            std::vector<const Subset*> mSubsets;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "DAutomaton.hpp"
+#include "NAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include <memory>
+
+// Machines and comparisons used by several test files, defined inline since all tests link into one binary
+
+// Binary words without two consecutive ones, the empty word included, a missing arc stands for the dead state
+inline std::shared_ptr<FACore::DFA> NoTwoOnes() {
+    std::shared_ptr<FACore::DFA> dfa( new FACore::DFA() );
+    auto afterZero = dfa->AddState(true);
+    auto afterOne = dfa->AddState(true);
+    dfa->SetArc(afterZero, 0, afterZero);
+    dfa->SetArc(afterZero, 1, afterOne);
+    dfa->SetArc(afterOne, 0, afterZero);
+    return dfa;
+}
+
+// Ternary words whose third symbol from the end is a 2, starting from state 0. The state
+// after the guessed 2 is only reached nondeterministically, so a DFA needs 8 states.
+inline std::shared_ptr<FACore::NAutomaton<3> > ThirdFromLastIsTwo() {
+    std::shared_ptr<FACore::NAutomaton<3> > nfa( new FACore::NAutomaton<3>() );
+    auto start = nfa->AddState(false);
+    auto first = nfa->AddState(false);
+    auto second = nfa->AddState(false);
+    auto third = nfa->AddState(true);
+    for(unsigned int c = 0; c < 3; c++) {
+        nfa->AddArc(start, c, start);
+        nfa->AddArc(first, c, second);
+        nfa->AddArc(second, c, third);
+    }
+    nfa->AddArc(start, 2, first);
+    return nfa;
+}
+
+// Accepts words with an odd number of ones, as numbers the ones of the Thue-Morse sequence
+inline FACore::DRegularLanguage<2> OddOnes() {
+    FACore::DFA *machine = new FACore::DFA();
+    auto evenState = machine->AddState(false);
+    auto oddState = machine->AddState(true);
+    machine->SetArc(evenState, 0, evenState);
+    machine->SetArc(evenState, 1, oddState);
+    machine->SetArc(oddState, 0, oddState);
+    machine->SetArc(oddState, 1, evenState);
+    return FACore::DRegularLanguage<2>(machine, evenState);
+}
+
+// Same states in the same order, with the same arcs and final states
+template<class Expected, class Actual>
+bool SameAutomaton(const Expected &expected, const Actual &actual) {
+    if(expected.GetNumStates() != actual.GetNumStates()) {
+        return false;
+    }
+    for(typename Expected::StateId state = 0; state < expected.GetNumStates(); state++) {
+        if(expected.IsFinal(state) != actual.IsFinal(state)) {
+            return false;
+        }
+        for(unsigned int label = 0; label < Expected::ALPHABET_SIZE; label++) {
+            if(expected.GetNext(state, label) != actual.GetNext(state, label)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "CompiledMatcher.hpp"
+#include "TestAutomata.hpp"
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE( TestCompiledMatcher );
+
+BOOST_AUTO_TEST_CASE( matches_language )
+{
+    DRegularLanguage<2> language(NoTwoOnes(), 0);
+    const CompiledMatcher<2> matcher(language);
+    BOOST_CHECK( matcher.GetNumStates() == 3 );
+    
+    mt19937 random(17);
+    for(unsigned int trial = 0; trial < 1000; trial++) {
+        vector<unsigned int> word(random() % 12);
+        for(unsigned int &label : word) {
+            label = random() % 2;
+        }
+        BOOST_CHECK( matcher.contains(word.begin(), word.end()) == language.contains(word.begin(), word.end()) );
+    }
+    for(unsigned int number = 0; number < 1000; number++) {
+        BOOST_CHECK( matcher.contains(number) == language.contains(number) );
+        BOOST_CHECK( matcher.containsNumber(static_cast<unsigned long long>(number)) == language.contains(number) );
+    }
+    
+    // Instrumented languages compile the same way, without counting a query
+    DRegularLanguage<2, unsigned int, CountingInstrumentation> counted(NoTwoOnes(), 0);
+    const CompiledMatcher<2> countedMatcher(counted);
+    BOOST_CHECK( countedMatcher.GetNumStates() == 3 );
+    BOOST_CHECK( countedMatcher.contains(5) && !countedMatcher.contains(3) );
+    BOOST_CHECK( counted.GetInstrumentation().GetNumQueries() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( sink_for_invalid_input )
+{
+    auto dfa = NoTwoOnes();
+    const CompiledMatcher<2> matcher(*dfa, 0);
+    
+    // Labels outside the alphabet lead to the sink, which is never left
+    vector<unsigned int> invalid = {0, 2, 0};
+    BOOST_CHECK( !matcher.contains(invalid.begin(), invalid.end()) );
+    vector<unsigned int> dead = {1, 1, 0, 0};
+    BOOST_CHECK( !matcher.contains(dead.begin(), dead.end()) );
+    
+    // So does an invalid initial state
+    const CompiledMatcher<2> invalidStart(*dfa, 7);
+    vector<unsigned int> empty;
+    BOOST_CHECK( !invalidStart.contains(empty.begin(), empty.end()) );
+    BOOST_CHECK( !invalidStart.contains(0u) );
+    
+    static_assert(noexcept(matcher.contains(dead.data(), dead.data() + dead.size())), "Pointer queries must not throw");
+}
+
+BOOST_AUTO_TEST_CASE( shared_across_threads )
+{
+    const CompiledMatcher<2> matcher(*NoTwoOnes(), 0);
+    vector<unsigned int> matches(4, 0);
+    vector<thread> threads;
+    for(unsigned int t = 0; t < 4; t++) {
+        threads.emplace_back([&matcher, &matches, t]() {
+            for(unsigned int number = 0; number < 4096; number++) {
+                matches[t] += matcher.contains(number);
+            }
+        });
+    }
+    for(thread &t : threads) {
+        t.join();
+    }
+    // Fibonacci: 4096 = 2^12 numbers, those of at most 12 bits without two adjacent ones
+    for(unsigned int t = 0; t < 4; t++) {
+        BOOST_CHECK( matches[t] == 377 );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
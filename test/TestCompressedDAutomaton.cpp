@@ -0,0 +1,104 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "CompressedDAutomaton.hpp"
+#include "DRegularLanguage.hpp"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// Byte strings that are a run of digits followed by a single letter, e.g. "2024x"
+static shared_ptr<DAutomaton<256> > DigitsThenLetter() {
+    shared_ptr<DAutomaton<256> > dfa( new DAutomaton<256>() );
+    auto start = dfa->AddState(false);
+    auto digits = dfa->AddState(false);
+    auto letter = dfa->AddState(true);
+    for(unsigned int c = '0'; c <= '9'; c++) {
+        dfa->SetArc(start, c, digits);
+        dfa->SetArc(digits, c, digits);
+    }
+    for(unsigned int c = 'a'; c <= 'z'; c++) {
+        dfa->SetArc(digits, c, letter);
+    }
+    return dfa;
+}
+
+BOOST_AUTO_TEST_SUITE( TestCompressedDAutomaton );
+
+BOOST_AUTO_TEST_CASE( byte_classes )
+{
+    auto dfa = DigitsThenLetter();
+    CompressedDAutomaton<256> compressed(*dfa);
+    
+    // Digits, letters and everything else
+    BOOST_CHECK( compressed.GetNumClasses() == 3 );
+    BOOST_CHECK( compressed.GetClass(0) == 0 );
+    BOOST_CHECK( compressed.GetClass('0') == 1 && compressed.GetClass('7') == 1 );
+    BOOST_CHECK( compressed.GetClass('a') == 2 && compressed.GetClass('q') == 2 );
+    BOOST_CHECK( compressed.GetClass('A') == 0 && compressed.GetClass(255) == 0 );
+    BOOST_CHECK( compressed.GetTableSize() < dfa->GetNumStates() * sizeof(DAutomaton<256>::TransitionArr) );
+    
+    BOOST_CHECK( compressed.GetNumStates() == dfa->GetNumStates() );
+    for(unsigned int state = 0; state <= dfa->GetNumStates(); state++) {
+        BOOST_CHECK( compressed.IsFinal(state) == dfa->IsFinal(state) );
+        for(unsigned int label = 0; label <= 256; label++) {
+            BOOST_CHECK( compressed.GetNext(state, label) == dfa->GetNext(state, label) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( same_language )
+{
+    auto dfa = DigitsThenLetter();
+    DRegularLanguage<256> language(dfa, 0);
+    DCompressedLanguage<256> compressed(*dfa, 0);
+    
+    for(string word : {"", "1", "12x", "x", "1x2", "007b", "9Z", "123"}) {
+        BOOST_CHECK( compressed.contains(word.begin(), word.end()) == language.contains(word.begin(), word.end()) );
+    }
+    vector<unsigned int> outside = {'1', 300};
+    BOOST_CHECK( !compressed.contains(outside.begin(), outside.end()) );
+    
+    DCompressedLanguage<256> invalid(*dfa, 5);
+    BOOST_CHECK( !invalid.contains(outside.begin(), outside.begin()) );
+}
+
+BOOST_AUTO_TEST_CASE( random_automata )
+{
+    mt19937 random(3);
+    for(unsigned int trial = 0; trial < 20; trial++) {
+        DAutomaton<10> dfa;
+        unsigned int numStates = 1 + random() % 10;
+        for(unsigned int state = 0; state < numStates; state++) {
+            dfa.AddState(random() % 2 == 0);
+        }
+        // Only a few distinct columns, so that labels do get merged
+        for(unsigned int state = 0; state < numStates; state++) {
+            for(unsigned int label = 0; label < 10; label++) {
+                if(label % 3 != 2 || random() % 2 == 0) {
+                    dfa.SetArc(state, label, (state + label % 3) % numStates);
+                }
+            }
+        }
+        
+        CompressedDAutomaton<10> compressed(dfa);
+        BOOST_CHECK( compressed.GetNumClasses() <= 10 );
+        for(unsigned int state = 0; state < numStates; state++) {
+            for(unsigned int label = 0; label < 10; label++) {
+                BOOST_CHECK( compressed.GetNext(state, label) == dfa.GetNext(state, label) );
+            }
+        }
+        
+        DRegularLanguage<10> language(new DAutomaton<10>(dfa), 0);
+        DCompressedLanguage<10> compressedLanguage(dfa, 0);
+        for(unsigned int number = 0; number < 2000; number++) {
+            BOOST_CHECK( compressedLanguage.contains(number) == language.contains(number) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,73 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Counting.hpp"
+#include "TestAutomata.hpp"
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+using namespace FACore;
+using namespace std;
+
+// Accepts numbers whose base 3 digits are all 0 or 2, the twos are partial arcs
+static DRegularLanguage<3> NoTernaryOnes() {
+    DAutomaton<3> *machine = new DAutomaton<3>();
+    auto state = machine->AddState(true);
+    machine->SetArc(state, 0, state);
+    machine->SetArc(state, 2, state);
+    return DRegularLanguage<3>(machine, state);
+}
+
+BOOST_AUTO_TEST_SUITE( TestCounting );
+
+BOOST_AUTO_TEST_CASE( matches_contains )
+{
+    DRegularLanguage<2> thueMorse = OddOnes();
+    DRegularLanguage<3> noOnes = NoTernaryOnes();
+    
+    for(unsigned int low = 0; low < 40; low += 3) {
+        for(unsigned int high = low; high < 300; high += 7) {
+            unsigned int expectedThueMorse = 0, expectedNoOnes = 0;
+            for(unsigned int number = low; number <= high; number++) {
+                expectedThueMorse += thueMorse.contains(number);
+                expectedNoOnes += noOnes.contains(number);
+            }
+            BOOST_CHECK( CountAccepted(thueMorse, low, high) == expectedThueMorse );
+            BOOST_CHECK( CountAccepted(noOnes, low, high) == expectedNoOnes );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( empty_ranges )
+{
+    DRegularLanguage<2> thueMorse = OddOnes();
+    BOOST_CHECK( CountAccepted(thueMorse, 10u, 9u) == 0 );
+    BOOST_CHECK( CountAccepted(thueMorse, 0u, 0u) == 0 );
+    BOOST_CHECK( CountAccepted(thueMorse, 1u, 1u) == 1 );
+    
+    DRegularLanguage<2> empty(new DFA(), 0);
+    BOOST_CHECK( CountAccepted(empty, 0u, 1000u) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( wide_bounds )
+{
+    DRegularLanguage<2> thueMorse = OddOnes();
+    
+    // Exactly half of the numbers below a power of two have an odd number of ones
+    uint64_t maxWord = numeric_limits<uint64_t>::max();
+    BOOST_CHECK( CountAcceptedUpTo(thueMorse, maxWord) == AcceptedCount(1) << 63 );
+    
+    unsigned __int128 maxDoubleWord = ~static_cast<unsigned __int128>(0);
+    BOOST_CHECK( CountAcceptedUpTo(thueMorse, maxDoubleWord) == AcceptedCount(1) << 127 );
+    
+    AcceptedCount huge = (AcceptedCount(1) << 300) - 1;
+    BOOST_CHECK( CountAcceptedUpTo(thueMorse, huge) == AcceptedCount(1) << 299 );
+    
+    // 3^40 - 1 is forty twos in base 3, every number with digits 0 and 2 is below it
+    AcceptedCount allTwos = boost::multiprecision::pow(AcceptedCount(3), 40) - 1;
+    BOOST_CHECK( CountAccepted(NoTernaryOnes(), AcceptedCount(0), allTwos) == AcceptedCount(1) << 40 );
+    BOOST_CHECK( CountAccepted(NoTernaryOnes(), AcceptedCount(1), allTwos) == (AcceptedCount(1) << 40) - 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,70 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DAutomatonBuilder.hpp"
+#include <stdexcept>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE( TestDAutomatonBuilder )
+
+BOOST_AUTO_TEST_CASE( empty_builder )
+{
+    DFABuilder builder;
+    DFA dfa = builder.Freeze();
+    BOOST_CHECK( dfa.GetNumStates() == 0 );
+    BOOST_CHECK( dfa.GetNext(0,0) == DFA::INVALID_STATE );
+}
+
+BOOST_AUTO_TEST_CASE( bulk_states_and_arcs )
+{
+    DAutomatonBuilder<3> builder;
+    builder.Reserve(4);
+    auto first = builder.AddStates(3, false);
+    auto last = builder.AddState(true);
+    builder.SetFinal(first, true);
+    BOOST_CHECK( first == 0 );
+    BOOST_CHECK( last == 3 );
+    
+    // A run of states counting ones, the same arc given twice keeps the later one
+    vector<DAutomatonBuilder<3>::Arc> arcs = {
+        {0, 1, 1}, {1, 1, 2}, {2, 1, 3}, {3, 0, 3}, {3, 0, 0}
+    };
+    builder.SetArcs(arcs);
+    builder.SetArc(0, 2, 0);
+    BOOST_CHECK( builder.GetNumStates() == 4 );
+    
+    DAutomaton<3> dfa = builder.Freeze();
+    BOOST_CHECK( dfa.GetNumStates() == 4 );
+    BOOST_CHECK( dfa.IsFinal(0) && !dfa.IsFinal(1) && !dfa.IsFinal(2) && dfa.IsFinal(3) );
+    BOOST_CHECK( dfa.GetNext(0,1) == 1 );
+    BOOST_CHECK( dfa.GetNext(2,1) == 3 );
+    BOOST_CHECK( dfa.GetNext(3,0) == 0 );
+    BOOST_CHECK( dfa.GetNext(0,2) == 0 );
+    BOOST_CHECK( dfa.GetNext(0,0) == DAutomaton<3>::INVALID_STATE );
+    
+    // The builder starts over after freezing
+    BOOST_CHECK( builder.GetNumStates() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( invalid_batches_change_nothing )
+{
+    DFABuilder builder;
+    builder.AddStates(2, false);
+    
+    vector<DFABuilder::Arc> badLabel = { {0, 0, 1}, {0, 2, 1} };
+    vector<DFABuilder::Arc> badSrc = { {0, 0, 1}, {2, 0, 1} };
+    vector<DFABuilder::Arc> badDest = { {0, 0, 1}, {1, 0, 2} };
+    BOOST_CHECK_THROW( builder.SetArcs(badLabel), std::out_of_range );
+    BOOST_CHECK_THROW( builder.SetArcs(badSrc), std::out_of_range );
+    BOOST_CHECK_THROW( builder.SetArcs(badDest), std::out_of_range );
+    BOOST_CHECK_THROW( builder.SetArc(0, 0, 5), std::out_of_range );
+    BOOST_CHECK_THROW( builder.SetFinal(2, true), std::out_of_range );
+    
+    DFA dfa = builder.Freeze();
+    BOOST_CHECK( dfa.GetNext(0,0) == DFA::INVALID_STATE );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include "DRegularLanguage.hpp"
 #include <memory>
+#include <cstdint>
+
+#include <boost/multiprecision/cpp_int.hpp>
 
 using namespace FACore;
 using namespace std;
@@ -118,4 +121,118 @@ BOOST_AUTO_TEST_CASE( thue_morse )
     BOOST_CHECK( InLanguage(thueMorseSequence, {1,0,0}) );
 }
 
+BOOST_AUTO_TEST_CASE( contains_batch )
+{
+    // Accepts numbers whose base 4 digits sum to an odd value
+    DAutomaton<4> *machine = new DAutomaton<4>();
+    auto evenState = machine->AddState(false);
+    auto oddState = machine->AddState(true);
+    for(unsigned int c = 0; c < 4; c++) {
+        machine->SetArc(evenState, c, c % 2 == 0 ? evenState : oddState);
+        machine->SetArc(oddState, c, c % 2 == 0 ? oddState : evenState);
+    }
+    DRegularLanguage<4> language(machine, evenState);
+    
+    std::vector<unsigned int> numbers;
+    for(unsigned int number = 0; number < 1000; number++) {
+        numbers.push_back(number * 7919u);
+    }
+    numbers.push_back(0xffffffffu);
+    
+    boost::dynamic_bitset<> out;
+    language.containsBatch(numbers.begin(), numbers.end(), out);
+    BOOST_REQUIRE( out.size() == numbers.size() );
+    for(std::size_t i = 0; i < numbers.size(); i++) {
+        BOOST_CHECK( out[i] == language.contains(numbers[i]) );
+    }
+    
+    // The pointer form handles a partial final batch the same way
+    language.containsBatch(numbers.data(), 11, out);
+    BOOST_REQUIRE( out.size() == 11 );
+    for(std::size_t i = 0; i < 11; i++) {
+        BOOST_CHECK( out[i] == language.contains(numbers[i]) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( contains_batch_partial_automaton )
+{
+    // Base 3 numbers without a 2 digit, the 2 arcs are left undefined
+    DAutomaton<3> *machine = new DAutomaton<3>();
+    auto state = machine->AddState(true);
+    machine->SetArc(state, 0, state);
+    machine->SetArc(state, 1, state);
+    DRegularLanguage<3> language(machine, state);
+    
+    std::vector<unsigned int> numbers;
+    for(unsigned int number = 0; number < 300; number++) {
+        numbers.push_back(number);
+    }
+    
+    boost::dynamic_bitset<> out;
+    language.containsBatch(numbers.begin(), numbers.end(), out);
+    BOOST_REQUIRE( out.size() == numbers.size() );
+    for(std::size_t i = 0; i < numbers.size(); i++) {
+        BOOST_CHECK( out[i] == language.contains(numbers[i]) );
+    }
+    
+    DRegularLanguage<3> emptyLanguage = EmptyLanguage<3>();
+    emptyLanguage.containsBatch(numbers.begin(), numbers.end(), out);
+    BOOST_CHECK( out.size() == numbers.size() );
+    BOOST_CHECK( out.none() );
+}
+
+BOOST_AUTO_TEST_CASE( contains_number_wide_types )
+{
+    // Base 4 words whose first digit is a 3
+    DAutomaton<4> *machine = new DAutomaton<4>();
+    auto start = machine->AddState(false);
+    auto accept = machine->AddState(true);
+    machine->SetArc(start, 3, accept);
+    for(unsigned int c = 0; c < 4; c++) {
+        machine->SetArc(accept, c, accept);
+    }
+    DRegularLanguage<4> language(machine, start);
+    
+    for(unsigned int number = 0; number < 300; number++) {
+        BOOST_CHECK( language.containsNumber(number) == language.contains(number) );
+        BOOST_CHECK( language.containsNumber(static_cast<uint64_t>(number)) == (number % 4 == 3) );
+    }
+    
+    // Low digit 3, top digit 1
+    uint64_t wide = (uint64_t(1) << 62) | 3;
+    BOOST_CHECK( language.containsNumber(wide) );
+    BOOST_CHECK( !language.containsNumber<DigitOrder::MostSignificantFirst>(wide) );
+    
+    unsigned __int128 wider = (static_cast<unsigned __int128>(3) << 126) | 1;
+    BOOST_CHECK( !language.containsNumber(wider) );
+    BOOST_CHECK( language.containsNumber<DigitOrder::MostSignificantFirst>(wider) );
+    
+    boost::multiprecision::cpp_int huge = (boost::multiprecision::cpp_int(3) << 1000) + 7;
+    BOOST_CHECK( language.containsNumber(huge) );
+    BOOST_CHECK( language.containsNumber<DigitOrder::MostSignificantFirst>(huge) );
+    BOOST_CHECK( !language.containsNumber<DigitOrder::MostSignificantFirst>(boost::multiprecision::cpp_int(0)) );
+}
+
+BOOST_AUTO_TEST_CASE( contains_number_non_power_of_two )
+{
+    // Base 3 numbers without a 2 digit, the 2 arcs are left undefined
+    DAutomaton<3> *machine = new DAutomaton<3>();
+    auto state = machine->AddState(true);
+    machine->SetArc(state, 0, state);
+    machine->SetArc(state, 1, state);
+    DRegularLanguage<3> language(machine, state);
+    
+    // Digit sets do not depend on the order
+    for(unsigned int number = 0; number < 300; number++) {
+        BOOST_CHECK( language.containsNumber(static_cast<unsigned __int128>(number)) == language.contains(number) );
+        BOOST_CHECK( language.containsNumber<DigitOrder::MostSignificantFirst>(number) == language.contains(number) );
+    }
+    
+    // 3^80 is a one followed by eighty zeros
+    boost::multiprecision::cpp_int power = boost::multiprecision::pow(boost::multiprecision::cpp_int(3), 80);
+    BOOST_CHECK( language.containsNumber(power) );
+    BOOST_CHECK( language.containsNumber<DigitOrder::MostSignificantFirst>(power) );
+    BOOST_CHECK( !language.containsNumber(boost::multiprecision::cpp_int(power * 2)) );
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,81 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DStrideLanguage.hpp"
+#include <memory>
+
+using namespace FACore;
+using namespace std;
+
+// Accepts numbers with an odd number of ones
+shared_ptr<const DFA> ThueMorseMachine() {
+    shared_ptr<DFA> machine( new DFA() );
+    auto evenState = machine->AddState(false);
+    auto oddState = machine->AddState(true);
+    machine->SetArc(evenState, 0, evenState);
+    machine->SetArc(evenState, 1, oddState);
+    machine->SetArc(oddState, 0, oddState);
+    machine->SetArc(oddState, 1, evenState);
+    return machine;
+}
+
+// Accepts base 3 numbers whose top digit is a 1 and which have no digit 2
+shared_ptr<const DAutomaton<3> > PartialMachine() {
+    shared_ptr<DAutomaton<3> > machine( new DAutomaton<3>() );
+    auto afterZero = machine->AddState(false);
+    auto afterOne = machine->AddState(true);
+    machine->SetArc(afterZero, 0, afterZero);
+    machine->SetArc(afterZero, 1, afterOne);
+    machine->SetArc(afterOne, 0, afterZero);
+    machine->SetArc(afterOne, 1, afterOne);
+    return machine;
+}
+
+BOOST_AUTO_TEST_SUITE( TestDStrideLanguage );
+
+BOOST_AUTO_TEST_CASE( byte_stride )
+{
+    DRegularLanguage<2> digitByDigit(ThueMorseMachine(), 0);
+    DStrideLanguage<2, 8> byteStride(ThueMorseMachine(), 0);
+    
+    BOOST_CHECK( byteStride.GetTableSize() == 2 * 2 * 256 * sizeof(DFA::StateId) );
+    for(unsigned int number = 0; number < 5000; number++) {
+        BOOST_CHECK( byteStride.contains(number) == digitByDigit.contains(number) );
+    }
+    BOOST_CHECK( byteStride.contains(0x80000000u) );
+    BOOST_CHECK( !byteStride.contains(0xffffffffu) );
+    
+    // The word overload is still the plain walk
+    std::vector<unsigned int> word {0, 0, 1};
+    BOOST_CHECK( byteStride.contains(word.begin(), word.end()) );
+}
+
+BOOST_AUTO_TEST_CASE( through_base_class )
+{
+    unique_ptr<DRegularLanguage<2> > language( new DStrideLanguage<2, 3>(ThueMorseMachine(), 0) );
+    BOOST_CHECK( language->contains(7) );
+    BOOST_CHECK( !language->contains(15) );
+    BOOST_CHECK( language->contains(31) );
+}
+
+BOOST_AUTO_TEST_CASE( partial_automaton )
+{
+    DRegularLanguage<3> digitByDigit(PartialMachine(), 0);
+    DStrideLanguage<3, 1> strideOne(PartialMachine(), 0);
+    DStrideLanguage<3, 4> strideFour(PartialMachine(), 0);
+    
+    for(unsigned int number = 0; number < 3 * 3 * 3 * 3 * 3 * 3 * 3; number++) {
+        BOOST_CHECK( strideOne.contains(number) == digitByDigit.contains(number) );
+        BOOST_CHECK( strideFour.contains(number) == digitByDigit.contains(number) );
+    }
+    BOOST_CHECK( !strideFour.contains(0xffffffffu) );
+}
+
+BOOST_AUTO_TEST_CASE( invalid_initial_state )
+{
+    DStrideLanguage<2, 4> language(shared_ptr<const DFA>(new DFA()), 0);
+    BOOST_CHECK( !language.contains(0) );
+    BOOST_CHECK( !language.contains(12345) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
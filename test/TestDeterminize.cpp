@@ -0,0 +1,117 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Determinize.hpp"
+#include <memory>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// Compares both languages on every word up to maxLength
+template<unsigned int ALPHABET_SIZE>
+bool SameWords(NRegularLanguage<ALPHABET_SIZE> &expected, DRegularLanguage<ALPHABET_SIZE> &actual, unsigned int maxLength) {
+    vector<unsigned int> word;
+    for(unsigned int length = 0; length <= maxLength; length++) {
+        word.assign(length, 0);
+        while(true) {
+            if(expected.contains(word.begin(), word.end()) != actual.contains(word.begin(), word.end())) {
+                return false;
+            }
+            unsigned int position = 0;
+            while(position < length && ++word[position] == ALPHABET_SIZE) {
+                word[position++] = 0;
+            }
+            if(position == length) {
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_SUITE( TestDeterminize );
+
+BOOST_AUTO_TEST_CASE( empty_initial_set )
+{
+    NFA nfa;
+    nfa.AddState(true);
+    
+    auto result = Determinize(nfa, {});
+    BOOST_CHECK( result.initialState == DFA::INVALID_STATE );
+    BOOST_CHECK( result.automaton.GetNumStates() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( deterministic_input_keeps_size )
+{
+    NFA nfa;
+    auto evenState = nfa.AddState(false);
+    auto oddState = nfa.AddState(true);
+    nfa.AddArc(evenState, 0, evenState);
+    nfa.AddArc(evenState, 1, oddState);
+    nfa.AddArc(oddState, 0, oddState);
+    nfa.AddArc(oddState, 1, evenState);
+    
+    auto result = Determinize(nfa, {evenState});
+    BOOST_CHECK( result.automaton.GetNumStates() == 2 );
+    BOOST_CHECK( !result.automaton.IsFinal(result.initialState) );
+}
+
+BOOST_AUTO_TEST_CASE( second_to_last_is_one )
+{
+    NFA *nfa = new NFA();
+    auto start = nfa->AddState(false);
+    auto seenOne = nfa->AddState(false);
+    auto done = nfa->AddState(true);
+    nfa->AddArc(start, 0, start);
+    nfa->AddArc(start, 1, start);
+    nfa->AddArc(start, 1, seenOne);
+    nfa->AddArc(seenOne, 0, done);
+    nfa->AddArc(seenOne, 1, done);
+    
+    NRegularLanguage<2> language(nfa, start);
+    DRegularLanguage<2> determinized = Determinize(language);
+    
+    BOOST_CHECK( determinized.GetAutomaton()->GetNumStates() == 4 );
+    BOOST_CHECK( SameWords(language, determinized, 8) );
+}
+
+BOOST_AUTO_TEST_CASE( multiple_initial_states )
+{
+    NAutomaton<3> *nfa = new NAutomaton<3>();
+    auto zeros = nfa->AddState(true);
+    auto twos = nfa->AddState(true);
+    auto sink = nfa->AddState(false);
+    nfa->AddArc(zeros, 0, zeros);
+    nfa->AddArc(twos, 2, twos);
+    nfa->AddArc(zeros, 1, sink);
+    
+    NRegularLanguage<3> language(shared_ptr<const NAutomaton<3> >(nfa), {zeros, twos});
+    DRegularLanguage<3> determinized = Determinize(language);
+    
+    BOOST_CHECK( SameWords(language, determinized, 6) );
+}
+
+BOOST_AUTO_TEST_CASE( epsilon_arcs )
+{
+    // 0* followed by 1*, then a 0 or nothing
+    NFA *nfa = new NFA();
+    auto zeros = nfa->AddState(false);
+    auto ones = nfa->AddState(false);
+    auto tail = nfa->AddState(false);
+    auto done = nfa->AddState(true);
+    nfa->AddArc(zeros, 0, zeros);
+    nfa->AddArc(ones, 1, ones);
+    nfa->AddArc(tail, 0, done);
+    nfa->AddEpsilonArc(zeros, ones);
+    nfa->AddEpsilonArc(ones, tail);
+    nfa->AddEpsilonArc(tail, done);
+    
+    NRegularLanguage<2> language(nfa, zeros);
+    DRegularLanguage<2> determinized = Determinize(language);
+    
+    BOOST_CHECK( determinized.GetAutomaton()->IsFinal(determinized.GetInitialState()) );
+    BOOST_CHECK( SameWords(language, determinized, 8) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
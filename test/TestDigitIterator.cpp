@@ -0,0 +1,87 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "utils/DigitIterator.hpp"
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+using namespace FACore;
+using namespace std;
+
+template<class Iter>
+vector<unsigned int> Digits(Iter begin, Iter end) {
+    vector<unsigned int> digits;
+    for(auto iter = begin; iter != end; ++iter) {
+        digits.push_back(*iter);
+    }
+    return digits;
+}
+
+// Both orders of the digits of number, checked against plain division on uint64_t
+template<unsigned int ALPHABET_SIZE, typename NumberType>
+bool SameDigits(uint64_t number) {
+    typedef DigitIterator<ALPHABET_SIZE, unsigned int, NumberType> Lsb;
+    typedef MostSignificantDigitIterator<ALPHABET_SIZE, unsigned int, NumberType> Msb;
+    
+    vector<unsigned int> expected;
+    for(uint64_t value = number; value != 0; value /= ALPHABET_SIZE) {
+        expected.push_back(value % ALPHABET_SIZE);
+    }
+    if(Digits(Lsb(NumberType(number)), Lsb::end()) != expected) {
+        return false;
+    }
+    reverse(expected.begin(), expected.end());
+    return Digits(Msb(NumberType(number)), Msb::end()) == expected;
+}
+
+BOOST_AUTO_TEST_SUITE( TestDigitIterator );
+
+BOOST_AUTO_TEST_CASE( power_of_two_alphabets )
+{
+    BOOST_CHECK( IsPowerOfTwo(1) && IsPowerOfTwo(2) && IsPowerOfTwo(256) );
+    BOOST_CHECK( !IsPowerOfTwo(0) && !IsPowerOfTwo(3) && !IsPowerOfTwo(10) );
+    BOOST_CHECK( FloorLog2(16) == 4 );
+    
+    vector<uint64_t> numbers {0, 1, 2, 3, 255, 256, 1000003, 0xffffffffull, 0x123456789abcdefull, ~uint64_t(0)};
+    for(uint64_t number : numbers) {
+        BOOST_CHECK(( SameDigits<2, uint64_t>(number) ));
+        BOOST_CHECK(( SameDigits<16, uint64_t>(number) ));
+        BOOST_CHECK(( SameDigits<8, unsigned __int128>(number) ));
+        BOOST_CHECK(( SameDigits<4, boost::multiprecision::cpp_int>(number) ));
+        if(number <= 0xffffffffull) {
+            BOOST_CHECK(( SameDigits<2, unsigned int>(number) ));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( other_alphabets )
+{
+    vector<uint64_t> numbers {0, 1, 2, 9, 10, 11, 999, 1000, 1000003, ~uint64_t(0)};
+    for(uint64_t number : numbers) {
+        BOOST_CHECK(( SameDigits<3, uint64_t>(number) ));
+        BOOST_CHECK(( SameDigits<10, unsigned __int128>(number) ));
+        BOOST_CHECK(( SameDigits<10, boost::multiprecision::cpp_int>(number) ));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( wider_than_64_bits )
+{
+    unsigned __int128 number = (static_cast<unsigned __int128>(5) << 123) | 6;
+    vector<unsigned int> lsb = Digits(DigitIterator<8, unsigned int, unsigned __int128>(number), DigitIterator<8, unsigned int, unsigned __int128>::end());
+    BOOST_CHECK( lsb.size() == 42 );
+    BOOST_CHECK( lsb.front() == 6 );
+    BOOST_CHECK( lsb.back() == 5 );
+    
+    boost::multiprecision::cpp_int huge = boost::multiprecision::pow(boost::multiprecision::cpp_int(10), 50) + 7;
+    typedef MostSignificantDigitIterator<10, unsigned int, boost::multiprecision::cpp_int> Msb;
+    vector<unsigned int> msb = Digits(Msb(huge), Msb::end());
+    BOOST_CHECK( msb.size() == 51 );
+    BOOST_CHECK( msb.front() == 1 );
+    BOOST_CHECK( msb.back() == 7 );
+    BOOST_CHECK( count(msb.begin(), msb.end(), 0) == 49 );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,128 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Enumerate.hpp"
+#include "TestAutomata.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE( TestEnumerate );
+
+BOOST_AUTO_TEST_CASE( words_in_shortlex_order )
+{
+    DRegularLanguage<2> thueMorse = OddOnes();
+    WordEnumerator<2> words(thueMorse);
+    BOOST_CHECK( words.IsInfinite() );
+    
+    vector<vector<unsigned int> > expected {
+        {1},
+        {0, 1}, {1, 0},
+        {0, 0, 1}, {0, 1, 0}, {1, 0, 0}, {1, 1, 1}
+    };
+    vector<unsigned int> word;
+    for(auto &expectedWord : expected) {
+        BOOST_CHECK( words.Next(word) );
+        BOOST_CHECK( word == expectedWord );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( finite_languages_end )
+{
+    // Accepts 0 and 1 1, with a dead end that is never entered
+    DFA *machine = new DFA();
+    auto start = machine->AddState(false);
+    auto zero = machine->AddState(true);
+    auto one = machine->AddState(false);
+    auto oneOne = machine->AddState(true);
+    auto deadEnd = machine->AddState(false);
+    machine->SetArc(start, 0, zero);
+    machine->SetArc(start, 1, one);
+    machine->SetArc(one, 1, oneOne);
+    machine->SetArc(one, 0, deadEnd);
+    machine->SetArc(deadEnd, 0, deadEnd);
+    DRegularLanguage<2> language(machine, start);
+    
+    WordEnumerator<2> words(language);
+    BOOST_CHECK( !words.IsInfinite() );
+    vector<unsigned int> word;
+    BOOST_CHECK( words.Next(word) && word == vector<unsigned int> {0} );
+    BOOST_CHECK(( words.Next(word) && word == vector<unsigned int> {1, 1} ));
+    BOOST_CHECK( !words.Next(word) );
+    BOOST_CHECK( !words.Next(word) );
+    
+    DRegularLanguage<2> empty(new DFA(), 0);
+    WordEnumerator<2> none(empty);
+    BOOST_CHECK( !none.Next(word) );
+}
+
+BOOST_AUTO_TEST_CASE( skip_to_kth_word )
+{
+    DRegularLanguage<2> thueMorse = OddOnes();
+    
+    // Half of the 2^L words of each length L > 0 are accepted, so 2^19 - 1 are shorter than 20
+    WordEnumerator<2> words(thueMorse);
+    words.Skip((1u << 19) - 1);
+    vector<unsigned int> word;
+    BOOST_CHECK( words.Next(word) );
+    BOOST_CHECK( word.size() == 20 );
+    BOOST_CHECK( word.back() == 1 );
+    for(std::size_t position = 0; position + 1 < word.size(); position++) {
+        BOOST_CHECK( word[position] == 0 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( numbers_in_increasing_order )
+{
+    DRegularLanguage<2> thueMorse = OddOnes();
+    NumberEnumerator<2> numbers(thueMorse);
+    
+    uint64_t number = 0;
+    for(unsigned int expected = 0; expected < 1000; expected++) {
+        if(thueMorse.contains(expected)) {
+            BOOST_CHECK( numbers.Next(number) );
+            BOOST_CHECK( number == expected );
+        }
+    }
+    
+    // Odious numbers: the k-th one is 2k or 2k + 1
+    NumberEnumerator<2> skipping(thueMorse);
+    skipping.Skip(1000000);
+    BOOST_CHECK( skipping.Next(number) );
+    BOOST_CHECK( number / 2 == 1000000 );
+    BOOST_CHECK( thueMorse.contains(static_cast<unsigned int>(number)) );
+}
+
+BOOST_AUTO_TEST_CASE( nautomaton_languages )
+{
+    // Numbers whose second lowest binary digit is one
+    NFA *nfa = new NFA();
+    auto start = nfa->AddState(false);
+    auto second = nfa->AddState(false);
+    auto rest = nfa->AddState(true);
+    nfa->AddArc(start, 0, second);
+    nfa->AddArc(start, 1, second);
+    nfa->AddArc(second, 1, rest);
+    nfa->AddArc(rest, 0, rest);
+    nfa->AddArc(rest, 1, rest);
+    NRegularLanguage<2> language(nfa, start);
+    
+    NumberEnumerator<2, unsigned int> numbers(language);
+    unsigned int number = 0;
+    vector<unsigned int> expected {2, 3, 6, 7, 10, 11};
+    for(unsigned int value : expected) {
+        BOOST_CHECK( numbers.Next(number) );
+        BOOST_CHECK( number == value );
+    }
+    
+    WordEnumerator<2> words(language);
+    vector<unsigned int> word;
+    BOOST_CHECK(( words.Next(word) && word == vector<unsigned int> {0, 1} ));
+    BOOST_CHECK(( words.Next(word) && word == vector<unsigned int> {1, 1} ));
+    BOOST_CHECK(( words.Next(word) && word == vector<unsigned int> {0, 1, 0} ));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
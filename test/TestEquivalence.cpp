@@ -0,0 +1,198 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Equivalence.hpp"
+#include "Minimize.hpp"
+#include "TestAutomata.hpp"
+#include <memory>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// Odd ones again, with every state duplicated, the copies alternate on each 0
+static DRegularLanguage<2> DuplicatedOddOnes() {
+    DFA *machine = new DFA();
+    auto even1 = machine->AddState(false);
+    auto odd1 = machine->AddState(true);
+    auto even2 = machine->AddState(false);
+    auto odd2 = machine->AddState(true);
+    machine->SetArc(even1, 0, even2);
+    machine->SetArc(even2, 0, even1);
+    machine->SetArc(odd1, 0, odd2);
+    machine->SetArc(odd2, 0, odd1);
+    machine->SetArc(even1, 1, odd1);
+    machine->SetArc(even2, 1, odd2);
+    machine->SetArc(odd1, 1, even2);
+    machine->SetArc(odd2, 1, even1);
+    return DRegularLanguage<2>(machine, even1);
+}
+
+// Accepts words with an odd number of ones that are shorter than maxLength
+static DRegularLanguage<2> ShortOddOnes(unsigned int maxLength) {
+    DFA *machine = new DFA();
+    for(unsigned int length = 0; length < maxLength; length++) {
+        machine->AddState(false);
+        machine->AddState(true);
+    }
+    for(unsigned int length = 0; length + 1 < maxLength; length++) {
+        machine->SetArc(2 * length, 0, 2 * length + 2);
+        machine->SetArc(2 * length, 1, 2 * length + 3);
+        machine->SetArc(2 * length + 1, 0, 2 * length + 3);
+        machine->SetArc(2 * length + 1, 1, 2 * length + 2);
+    }
+    return DRegularLanguage<2>(machine, 0);
+}
+
+BOOST_AUTO_TEST_SUITE( TestEquivalence );
+
+BOOST_AUTO_TEST_CASE( emptiness )
+{
+    DFA dfa;
+    BOOST_CHECK( IsEmpty(dfa, 0).holds );
+    
+    // The only final state is reachable by 1 0 1
+    auto start = dfa.AddState(false);
+    auto one = dfa.AddState(false);
+    auto oneZero = dfa.AddState(false);
+    auto done = dfa.AddState(true);
+    dfa.SetArc(start, 0, start);
+    dfa.SetArc(start, 1, one);
+    dfa.SetArc(one, 0, oneZero);
+    dfa.SetArc(oneZero, 1, done);
+    
+    LanguageCheckResult result = IsEmpty(dfa, start);
+    BOOST_CHECK( !result );
+    BOOST_CHECK(( result.counterexample == vector<unsigned int> {1, 0, 1} ));
+    
+    BOOST_CHECK( !IsEmpty(dfa, done) );
+    BOOST_CHECK( IsEmpty(dfa, done).counterexample.empty() );
+    BOOST_CHECK( IsEmpty(OddOnes()).counterexample == vector<unsigned int> {1} );
+}
+
+BOOST_AUTO_TEST_CASE( equivalent_languages )
+{
+    DRegularLanguage<2> odd = OddOnes();
+    DRegularLanguage<2> duplicated = DuplicatedOddOnes();
+    
+    BOOST_CHECK( AreEquivalent(odd, duplicated) );
+    BOOST_CHECK( AreEquivalent(duplicated, odd) );
+    BOOST_CHECK( AreEquivalent(odd, Minimize(duplicated)) );
+    
+    DRegularLanguage<2> empty(new DFA(), 0);
+    DRegularLanguage<2> alsoEmpty = ShortOddOnes(0);
+    BOOST_CHECK( AreEquivalent(empty, alsoEmpty) );
+}
+
+BOOST_AUTO_TEST_CASE( shortest_counterexample )
+{
+    DRegularLanguage<2> odd = OddOnes();
+    DRegularLanguage<2> shortOdd = ShortOddOnes(4);
+    
+    LanguageCheckResult result = AreEquivalent(odd, shortOdd);
+    BOOST_CHECK( !result.holds );
+    BOOST_CHECK( result.counterexample.size() == 4 );
+    BOOST_CHECK( odd.contains(result.counterexample.begin(), result.counterexample.end()) );
+    BOOST_CHECK( !shortOdd.contains(result.counterexample.begin(), result.counterexample.end()) );
+    
+    // The empty word tells apart languages that disagree on the initial state
+    DRegularLanguage<2> empty(new DFA(), 0);
+    DFA *epsilon = new DFA();
+    epsilon->AddState(true);
+    DRegularLanguage<2> onlyEpsilon(epsilon, 0);
+    result = AreEquivalent(empty, onlyEpsilon);
+    BOOST_CHECK( !result.holds );
+    BOOST_CHECK( result.counterexample.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( inclusion )
+{
+    DRegularLanguage<2> odd = OddOnes();
+    DRegularLanguage<2> shortOdd = ShortOddOnes(3);
+    
+    BOOST_CHECK( IsIncluded(shortOdd, odd) );
+    
+    LanguageCheckResult result = IsIncluded(odd, shortOdd);
+    BOOST_CHECK( !result );
+    BOOST_CHECK( result.counterexample.size() == 3 );
+    BOOST_CHECK( odd.contains(result.counterexample.begin(), result.counterexample.end()) );
+    
+    DRegularLanguage<2> empty(new DFA(), 0);
+    BOOST_CHECK( IsIncluded(empty, shortOdd) );
+    BOOST_CHECK( IsIncluded(odd, empty).counterexample == vector<unsigned int> {1} );
+}
+
+BOOST_AUTO_TEST_CASE( nautomaton_languages )
+{
+    // Second to last letter is one, guessed nondeterministically
+    NFA *guessing = new NFA();
+    auto start = guessing->AddState(false);
+    auto seenOne = guessing->AddState(false);
+    auto done = guessing->AddState(true);
+    guessing->AddArc(start, 0, start);
+    guessing->AddArc(start, 1, start);
+    guessing->AddArc(start, 1, seenOne);
+    guessing->AddArc(seenOne, 0, done);
+    guessing->AddArc(seenOne, 1, done);
+    NRegularLanguage<2> secondToLast(guessing, start);
+    
+    // The same language, remembering the last two letters
+    NFA *remembering = new NFA();
+    for(unsigned int lastTwo = 0; lastTwo < 4; lastTwo++) {
+        remembering->AddState(lastTwo >= 2);
+    }
+    for(unsigned int lastTwo = 0; lastTwo < 4; lastTwo++) {
+        remembering->AddArc(lastTwo, 0, (lastTwo << 1) & 3);
+        remembering->AddArc(lastTwo, 1, ((lastTwo << 1) & 3) | 1);
+    }
+    NRegularLanguage<2> alsoSecondToLast(remembering, 0);
+    
+    BOOST_CHECK( AreEquivalent(secondToLast, alsoSecondToLast) );
+    BOOST_CHECK( IsIncluded(secondToLast, alsoSecondToLast) );
+    BOOST_CHECK(( IsEmpty(secondToLast).counterexample == vector<unsigned int> {1, 0} ));
+    
+    NRegularLanguage<2> fromSeenOne(secondToLast.GetAutomaton(), {seenOne});
+    LanguageCheckResult result = AreEquivalent(secondToLast, fromSeenOne);
+    BOOST_CHECK( !result );
+    BOOST_CHECK( result.counterexample.size() == 1 );
+}
+
+BOOST_AUTO_TEST_CASE( nondeterministic_emptiness )
+{
+    // 0 0 reaches the final state in two arcs, 1 takes three arcs but two are epsilon
+    NFA *nfa = new NFA();
+    auto start = nfa->AddState(false);
+    auto afterZero = nfa->AddState(false);
+    auto first = nfa->AddState(false);
+    auto second = nfa->AddState(false);
+    auto done = nfa->AddState(true);
+    auto unreachable = nfa->AddState(true);
+    nfa->AddArc(start, 0, afterZero);
+    nfa->AddArc(afterZero, 0, done);
+    nfa->AddEpsilonArc(start, first);
+    nfa->AddEpsilonArc(first, second);
+    nfa->AddEpsilonArc(second, start);
+    nfa->AddArc(second, 1, done);
+    NRegularLanguage<2> language(nfa, start);
+    
+    LanguageCheckResult result = IsEmpty(language);
+    BOOST_CHECK( !result );
+    BOOST_CHECK(( result.counterexample == vector<unsigned int> {1} ));
+    
+    // The empty word, through epsilon arcs only
+    nfa->AddEpsilonArc(first, unreachable);
+    BOOST_CHECK( IsEmpty(*nfa, {afterZero, start}).counterexample.empty() );
+    BOOST_CHECK( !IsEmpty(*nfa, {afterZero, start}) );
+    
+    BOOST_CHECK( IsEmpty(*nfa, {}) );
+    BOOST_CHECK( IsEmpty(*nfa, {nfa->GetNumStates()}) );
+    
+    NFA *dead = new NFA();
+    auto loop = dead->AddState(false);
+    dead->AddState(true);
+    dead->AddArc(loop, 0, loop);
+    dead->AddEpsilonArc(loop, loop);
+    BOOST_CHECK( IsEmpty(NRegularLanguage<2>(dead, loop)) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,194 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+#include "Minimize.hpp"
+#include "ParallelMinimize.hpp"
+#include "Determinize.hpp"
+#include "ParallelDeterminize.hpp"
+#include "Trim.hpp"
+#include "RemoveEpsilons.hpp"
+#include "StateIdWidth.hpp"
+#include "Product.hpp"
+#include "Equivalence.hpp"
+#include "Counting.hpp"
+#include "Enumerate.hpp"
+#include "TestAutomata.hpp"
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+using namespace FACore;
+using namespace std;
+
+// Words whose second to last symbol is a 1
+static shared_ptr<const NFA> SecondToLastIsOne() {
+    shared_ptr<NFA> nfa( new NFA() );
+    auto start = nfa->AddState(false);
+    auto seenOne = nfa->AddState(false);
+    auto done = nfa->AddState(true);
+    nfa->AddArc(start, 0, start);
+    nfa->AddArc(start, 1, start);
+    nfa->AddArc(start, 1, seenOne);
+    nfa->AddArc(seenOne, 0, done);
+    nfa->AddArc(seenOne, 1, done);
+    return nfa;
+}
+
+BOOST_AUTO_TEST_SUITE( TestInstrumentation );
+
+BOOST_AUTO_TEST_CASE( default_policy_is_free )
+{
+    BOOST_CHECK( is_empty<NoInstrumentation>::value );
+    BOOST_CHECK( sizeof(DRegularLanguage<2>) == sizeof(DRegularLanguage<2, unsigned int, NoInstrumentation>) );
+    BOOST_CHECK(( sizeof(DRegularLanguage<2>) < sizeof(DRegularLanguage<2, unsigned int, CountingInstrumentation>) ));
+}
+
+BOOST_AUTO_TEST_CASE( deterministic_counters )
+{
+    DRegularLanguage<2, unsigned int, CountingInstrumentation> language(NoTwoOnes(), 0);
+    const CountingInstrumentation &counters = language.GetInstrumentation();
+    
+    vector<unsigned int> accepted = {0, 1, 0, 1};
+    vector<unsigned int> rejected = {1, 1, 0, 0, 0};
+    BOOST_CHECK( language.contains(accepted.begin(), accepted.end()) );
+    BOOST_CHECK( !language.contains(rejected.begin(), rejected.end()) );
+    
+    BOOST_CHECK( counters.GetNumQueries() == 2 );
+    // The rejected word died after its second symbol
+    BOOST_CHECK( counters.GetNumCharacters() == 4 + 2 );
+    BOOST_CHECK( counters.GetNumEarlyExits() == 1 );
+    BOOST_CHECK( counters.GetPeakActiveStates() == 0 );
+    
+    // Batches are counted number by number, 5 is 101 and 3 is 11
+    boost::dynamic_bitset<> out;
+    vector<unsigned int> numbers = {5, 3};
+    language.containsBatch(numbers.begin(), numbers.end(), out);
+    BOOST_CHECK( out[0] && !out[1] );
+    BOOST_CHECK( counters.GetNumQueries() == 4 );
+    BOOST_CHECK( counters.GetNumEarlyExits() == 1 );
+    
+    language.GetInstrumentation().Reset();
+    BOOST_CHECK( counters.GetNumQueries() == 0 );
+    BOOST_CHECK( counters.GetNumCharacters() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( nondeterministic_counters )
+{
+    typedef NRegularLanguage<2, unsigned int, CountingInstrumentation> Language;
+    
+    vector<unsigned int> word = {1, 1, 0, 1, 0};
+    for(SimulationMode mode : {SimulationMode::StateSet, SimulationMode::BitParallel, SimulationMode::LazyDFA}) {
+        Language language(SecondToLastIsOne(), {0}, mode);
+        const CountingInstrumentation &counters = language.GetInstrumentation();
+        
+        BOOST_CHECK( language.contains(word.begin(), word.end()) );
+        BOOST_CHECK( counters.GetNumQueries() == 1 );
+        BOOST_CHECK( counters.GetNumCharacters() == 5 );
+        BOOST_CHECK( counters.GetNumEarlyExits() == 0 );
+        // After 1 1 the start state, seenOne and done are all active
+        BOOST_CHECK( counters.GetPeakActiveStates() == 3 );
+        
+        // Invalid labels end the query early
+        vector<unsigned int> invalid = {0, 2, 1};
+        BOOST_CHECK( !language.contains(invalid.begin(), invalid.end()) );
+        BOOST_CHECK( counters.GetNumEarlyExits() == 1 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( lazy_dfa_hit_rate )
+{
+    NRegularLanguage<2, unsigned int, CountingInstrumentation> language(SecondToLastIsOne(), {0}, SimulationMode::LazyDFA);
+    const CountingInstrumentation &counters = language.GetInstrumentation();
+    
+    vector<unsigned int> word = {1, 1, 1, 1};
+    BOOST_CHECK( language.contains(word.begin(), word.end()) );
+    // {0} -1-> {0,1} -1-> {0,1,2} -1-> {0,1,2} -1-> {0,1,2}, only the last step was cached
+    BOOST_CHECK( counters.GetNumCacheMisses() == 3 );
+    BOOST_CHECK( counters.GetNumCacheHits() == 1 );
+    
+    BOOST_CHECK( language.contains(word.begin(), word.end()) );
+    BOOST_CHECK( counters.GetNumCacheMisses() == 3 );
+    BOOST_CHECK( counters.GetNumCacheHits() == 5 );
+    BOOST_CHECK( counters.GetCacheHitRate() == 5.0 / 8 );
+    
+    // The other modes have no cache
+    NRegularLanguage<2, unsigned int, CountingInstrumentation> stateSet(SecondToLastIsOne(), {0});
+    BOOST_CHECK( stateSet.contains(word.begin(), word.end()) );
+    BOOST_CHECK( stateSet.GetInstrumentation().GetNumCacheHits() + stateSet.GetInstrumentation().GetNumCacheMisses() == 0 );
+    BOOST_CHECK( stateSet.GetInstrumentation().GetCacheHitRate() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( operations_keep_the_policy )
+{
+    typedef DRegularLanguage<2, unsigned int, CountingInstrumentation> Counted;
+    typedef NRegularLanguage<2, unsigned int, CountingInstrumentation> CountedN;
+    
+    Counted noDouble(NoTwoOnes(), 0);
+    CountedN secondToLast(SecondToLastIsOne(), {0});
+    DRegularLanguage<2> plain(NoTwoOnes(), 0);
+    vector<unsigned int> word = {1, 0};
+    BOOST_CHECK( noDouble.contains(word.begin(), word.end()) );
+    
+    // Every operation returns a language of the same policy, or the left operand's one
+    Counted minimal = Minimize(noDouble);
+    Counted parallelMinimal = ParallelMinimize(noDouble, 2);
+    Counted determinized = Determinize(secondToLast);
+    Counted parallelDeterminized = ParallelDeterminize(secondToLast, 2);
+    Counted trimmed = Trim(noDouble);
+    CountedN trimmedN = Trim(secondToLast);
+    CountedN withoutEpsilons = RemoveEpsilons(secondToLast);
+    DRegularLanguage<2, uint8_t, CountingInstrumentation> narrow = ConvertStateWidth<uint8_t>(noDouble);
+    NRegularLanguage<2, uint8_t, CountingInstrumentation> narrowN = ConvertStateWidth<uint8_t>(secondToLast);
+    Counted both = Intersection(noDouble, determinized);
+    Counted either = Union(noDouble, plain);
+    Counted only = Difference(noDouble, determinized);
+    Counted complement = Complement(noDouble);
+    
+    // The new languages count their own queries only
+    BOOST_CHECK( minimal.GetInstrumentation().GetNumQueries() == 0 );
+    BOOST_CHECK( minimal.contains(word.begin(), word.end()) );
+    BOOST_CHECK( parallelMinimal.contains(word.begin(), word.end()) );
+    BOOST_CHECK( determinized.contains(word.begin(), word.end()) );
+    BOOST_CHECK( parallelDeterminized.contains(word.begin(), word.end()) );
+    BOOST_CHECK( trimmed.contains(word.begin(), word.end()) );
+    BOOST_CHECK( trimmedN.contains(word.begin(), word.end()) );
+    BOOST_CHECK( withoutEpsilons.contains(word.begin(), word.end()) );
+    BOOST_CHECK( narrow.contains(word.begin(), word.end()) );
+    BOOST_CHECK( narrowN.contains(word.begin(), word.end()) );
+    BOOST_CHECK( both.contains(word.begin(), word.end()) );
+    BOOST_CHECK( either.contains(word.begin(), word.end()) );
+    BOOST_CHECK( !only.contains(word.begin(), word.end()) );
+    BOOST_CHECK( !complement.contains(word.begin(), word.end()) );
+    BOOST_CHECK( minimal.GetInstrumentation().GetNumQueries() == 1 );
+    BOOST_CHECK( noDouble.GetInstrumentation().GetNumQueries() == 1 );
+    
+    LazyProduct<2> lazy(noDouble, plain, ProductOperation::Intersection);
+    BOOST_CHECK( lazy.contains(word.begin(), word.end()) );
+    
+    // The checks accept any mix of policies
+    BOOST_CHECK( !IsEmpty(noDouble) );
+    BOOST_CHECK( !IsEmpty(secondToLast) );
+    BOOST_CHECK( AreEquivalent(noDouble, plain) );
+    BOOST_CHECK( IsIncluded(plain, noDouble) );
+    BOOST_CHECK( AreEquivalent(secondToLast, trimmedN) );
+    
+    // 0, 1 and 2 have no two consecutive ones
+    BOOST_CHECK( CountAcceptedUpTo(noDouble, 2u) == 3 );
+    BOOST_CHECK( CountAccepted(noDouble, 1u, 2u) == 2 );
+    
+    WordEnumerator<2> words(noDouble);
+    WordEnumerator<2> wordsN(secondToLast);
+    NumberEnumerator<2> numbers(noDouble);
+    NumberEnumerator<2> numbersN(secondToLast);
+    vector<unsigned int> next;
+    BOOST_CHECK( words.Next(next) && next.empty() );
+    BOOST_CHECK( wordsN.Next(next) && next == vector<unsigned int>({1, 0}) );
+    uint64_t number;
+    BOOST_CHECK( numbers.Next(number) && number == 0 );
+    // Numbers are read low digit first, 3 is the first whose second digit is a 1
+    BOOST_CHECK( numbersN.Next(number) && number == 3 );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,142 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "MappedDAutomaton.hpp"
+#include "Matcher.hpp"
+#include "CompiledMatcher.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace FACore;
+using namespace std;
+
+static const char *MAPPED_FILE = "TestMappedDAutomaton.bin";
+
+// Thue morse with a third label that is only defined on the odd state
+static DAutomaton<3> ThueMorseMachine() {
+    DAutomaton<3> machine;
+    auto evenState = machine.AddState(false);
+    auto oddState = machine.AddState(true);
+    machine.SetArc(evenState, 0, evenState);
+    machine.SetArc(evenState, 1, oddState);
+    machine.SetArc(oddState, 0, oddState);
+    machine.SetArc(oddState, 1, evenState);
+    machine.SetArc(oddState, 2, oddState);
+    return machine;
+}
+
+BOOST_AUTO_TEST_SUITE( TestMappedDAutomaton );
+
+BOOST_AUTO_TEST_CASE( serves_saved_automaton )
+{
+    DAutomaton<3> machine = ThueMorseMachine();
+    SaveAutomaton(machine, MAPPED_FILE);
+    
+    {
+        MappedDAutomaton<3> mapped(MAPPED_FILE);
+        BOOST_CHECK( mapped.GetNumStates() == 2 );
+        for(unsigned int state = 0; state < 3; state++) {
+            BOOST_CHECK( mapped.IsFinal(state) == machine.IsFinal(state) );
+            for(unsigned int label = 0; label < 4; label++) {
+                BOOST_CHECK( mapped.GetNext(state, label) == machine.GetNext(state, label) );
+            }
+        }
+        BOOST_CHECK( mapped.GetTransitionTable()[1][2] == 1 );
+        
+        MappedDAutomaton<3> moved(std::move(mapped));
+        BOOST_CHECK( moved.GetNext(0, 1) == 1 );
+        BOOST_CHECK( moved.IsFinal(1) );
+    }
+    std::remove(MAPPED_FILE);
+}
+
+BOOST_AUTO_TEST_CASE( many_final_words )
+{
+    // More than one word of final bits
+    DAutomaton<2, uint16_t> machine;
+    for(unsigned int state = 0; state < 200; state++) {
+        machine.AddState(state % 5 == 0);
+    }
+    for(unsigned int state = 0; state < 200; state++) {
+        machine.SetArc(state, 1, (state + 1) % 200);
+    }
+    SaveAutomaton(machine, MAPPED_FILE);
+    
+    {
+        MappedDAutomaton<2, uint16_t> mapped(MAPPED_FILE);
+        BOOST_CHECK( mapped.GetNumStates() == 200 );
+        for(unsigned int state = 0; state < 200; state++) {
+            BOOST_CHECK( mapped.IsFinal(state) == (state % 5 == 0) );
+            BOOST_CHECK( mapped.GetNext(state, 0) == mapped.INVALID_STATE );
+            BOOST_CHECK( mapped.GetNext(state, 1) == (state + 1) % 200 );
+        }
+    }
+    std::remove(MAPPED_FILE);
+}
+
+BOOST_AUTO_TEST_CASE( queried_in_place )
+{
+    DAutomaton<3> machine = ThueMorseMachine();
+    SaveAutomaton(machine, MAPPED_FILE);
+    
+    {
+        shared_ptr<const MappedDAutomaton<3> > mapped( new MappedDAutomaton<3>(MAPPED_FILE) );
+        MappedDRegularLanguage<3> language(mapped, 0);
+        DRegularLanguage<3> loaded(new DAutomaton<3>(machine), 0);
+        BOOST_CHECK( language.GetAutomaton() == mapped );
+        
+        for(unsigned int number = 0; number < 243; number++) {
+            BOOST_CHECK( language.contains(number) == loaded.contains(number) );
+        }
+        vector<unsigned int> numbers = {0, 1, 2, 5, 7, 100};
+        boost::dynamic_bitset<> expected, out;
+        loaded.containsBatch(numbers.begin(), numbers.end(), expected);
+        language.containsBatch(numbers.begin(), numbers.end(), out);
+        BOOST_CHECK( out == expected );
+        
+        vector<std::size_t> offsets, expectedOffsets;
+        vector<unsigned int> word = {0, 1, 2, 1};
+        language.scan(word.begin(), word.end(), [&](std::size_t offset) { offsets.push_back(offset); });
+        loaded.scan(word.begin(), word.end(), [&](std::size_t offset) { expectedOffsets.push_back(offset); });
+        BOOST_CHECK(( offsets == vector<std::size_t> {2, 3, 4} ));
+        BOOST_CHECK( offsets == expectedOffsets );
+        
+        DMatcher<3, unsigned int, MappedDAutomaton<3> > matcher(language);
+        matcher.feed(word.begin(), word.begin() + 2);
+        BOOST_CHECK( matcher.isAccepting() );
+        matcher.feed(word.begin() + 2, word.end());
+        BOOST_CHECK( !matcher.isAccepting() && !matcher.isDead() );
+        
+        const CompiledMatcher<3> compiled(language);
+        const CompiledMatcher<3> compiledMachine(*mapped, 0);
+        for(unsigned int number = 0; number < 243; number++) {
+            BOOST_CHECK( compiled.contains(number) == loaded.contains(number) );
+            BOOST_CHECK( compiledMachine.contains(number) == loaded.contains(number) );
+        }
+    }
+    std::remove(MAPPED_FILE);
+}
+
+BOOST_AUTO_TEST_CASE( rejects_bad_files )
+{
+    SaveAutomaton(ThueMorseMachine(), MAPPED_FILE);
+    BOOST_CHECK_THROW( MappedDAutomaton<2> mapped(MAPPED_FILE), std::runtime_error );
+    
+    // Cut off the final state bits
+    {
+        ifstream in(MAPPED_FILE, ios::binary);
+        string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        in.close();
+        ofstream out(MAPPED_FILE, ios::binary | ios::trunc);
+        out << bytes.substr(0, bytes.size() - 8);
+    }
+    BOOST_CHECK_THROW( MappedDAutomaton<3> mapped(MAPPED_FILE), std::runtime_error );
+    std::remove(MAPPED_FILE);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,151 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Matcher.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// Feeds word in chunks cut at random places
+template<class Matcher>
+void FeedInChunks(Matcher &matcher, const vector<unsigned int> &word, mt19937 &random) {
+    std::size_t position = 0;
+    while(position < word.size()) {
+        std::size_t length = random() % (word.size() - position + 1);
+        matcher.feed(word.begin() + position, word.begin() + position + length);
+        position += length;
+    }
+}
+
+// Words whose third symbol from the end is a 1, with an epsilon arc standing in for one of the steps
+static NRegularLanguage<2> ThirdFromLast() {
+    shared_ptr<NFA> nfa( new NFA() );
+    auto start = nfa->AddState(false);
+    auto seenOne = nfa->AddState(false);
+    auto skip = nfa->AddState(false);
+    auto second = nfa->AddState(false);
+    auto done = nfa->AddState(true);
+    nfa->AddArc(start, 0, start);
+    nfa->AddArc(start, 1, start);
+    nfa->AddArc(start, 1, seenOne);
+    nfa->AddEpsilonArc(seenOne, skip);
+    nfa->AddArc(skip, 0, second);
+    nfa->AddArc(skip, 1, second);
+    nfa->AddArc(second, 0, done);
+    nfa->AddArc(second, 1, done);
+    return NRegularLanguage<2>(nfa, {start});
+}
+
+BOOST_AUTO_TEST_SUITE( TestMatcher );
+
+BOOST_AUTO_TEST_CASE( deterministic_chunks )
+{
+    // Binary words with an even number of ones and no 0 right after a 1 1
+    shared_ptr<DFA> dfa( new DFA() );
+    auto even = dfa->AddState(true);
+    auto odd = dfa->AddState(false);
+    auto evenAfterPair = dfa->AddState(true);
+    dfa->SetArc(even, 0, even);
+    dfa->SetArc(even, 1, odd);
+    dfa->SetArc(odd, 0, even);
+    dfa->SetArc(odd, 1, evenAfterPair);
+    dfa->SetArc(evenAfterPair, 1, odd);
+    DRegularLanguage<2> language(dfa, even);
+    
+    DMatcher<2> matcher(language);
+    mt19937 random(7);
+    for(unsigned int trial = 0; trial < 500; trial++) {
+        vector<unsigned int> word(random() % 20);
+        for(unsigned int &label : word) {
+            label = random() % 2;
+        }
+        matcher.reset();
+        FeedInChunks(matcher, word, random);
+        BOOST_CHECK( matcher.isAccepting() == language.contains(word.begin(), word.end()) );
+    }
+    
+    matcher.reset();
+    vector<unsigned int> dead = {1, 1, 0};
+    matcher.feed(dead.begin(), dead.begin() + 2);
+    BOOST_CHECK( matcher.isAccepting() && !matcher.isDead() );
+    matcher.feed(dead.begin() + 2, dead.end());
+    BOOST_CHECK( matcher.isDead() && !matcher.isAccepting() );
+    matcher.feed(dead.begin(), dead.end());
+    BOOST_CHECK( matcher.isDead() );
+    
+    matcher.reset();
+    BOOST_CHECK( matcher.GetCurrentState() == even );
+    BOOST_CHECK( matcher.isAccepting() );
+}
+
+BOOST_AUTO_TEST_CASE( nondeterministic_chunks )
+{
+    NRegularLanguage<2> language = ThirdFromLast();
+    NMatcher<2> matcher(language);
+    BOOST_CHECK( !matcher.isAccepting() );
+    
+    mt19937 random(11);
+    for(unsigned int trial = 0; trial < 500; trial++) {
+        vector<unsigned int> word(random() % 20);
+        for(unsigned int &label : word) {
+            label = random() % 2;
+        }
+        matcher.reset();
+        FeedInChunks(matcher, word, random);
+        BOOST_CHECK( matcher.isAccepting() == language.contains(word.begin(), word.end()) );
+        BOOST_CHECK( matcher.GetActiveStates().size() <= language.GetAutomaton()->GetNumStates() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( nondeterministic_closure_and_dead_input )
+{
+    NRegularLanguage<2> language = ThirdFromLast();
+    NMatcher<2> matcher(language.GetAutomaton(), {0});
+    
+    // The epsilon arc makes skip active together with seenOne
+    vector<unsigned int> one = {1};
+    matcher.feed(one.begin(), one.end());
+    BOOST_CHECK( matcher.GetActiveStates().size() == 3 );
+    
+    // Labels outside the alphabet kill the match
+    vector<unsigned int> invalid = {2};
+    matcher.feed(invalid.begin(), invalid.end());
+    BOOST_CHECK( matcher.isDead() && !matcher.isAccepting() );
+    
+    matcher.reset();
+    vector<unsigned int> word = {1, 0, 0};
+    matcher.feed(word.begin(), word.end());
+    BOOST_CHECK( matcher.isAccepting() );
+    
+    // A matcher over no valid initial state is dead from the start
+    NMatcher<2> empty(language.GetAutomaton(), {42});
+    BOOST_CHECK( empty.isDead() );
+}
+
+BOOST_AUTO_TEST_CASE( instrumented_languages_and_shared_closures )
+{
+    typedef NRegularLanguage<2, unsigned int, CountingInstrumentation> Language;
+    
+    NRegularLanguage<2> plain = ThirdFromLast();
+    Language language(plain.GetAutomaton(), plain.GetInitialStates());
+    const long owners = language.GetEpsilonClosure().use_count();
+    NMatcher<2> matcher(language);
+    BOOST_CHECK( language.GetEpsilonClosure().use_count() == owners + 1 );
+    
+    vector<unsigned int> word = {1, 1, 0};
+    matcher.feed(word.begin(), word.end());
+    BOOST_CHECK( matcher.isAccepting() );
+    
+    shared_ptr<DFA> dfa( new DFA() );
+    auto state = dfa->AddState(true);
+    dfa->SetArc(state, 0, state);
+    DRegularLanguage<2, unsigned int, CountingInstrumentation> deterministic(dfa, state);
+    DMatcher<2> dMatcher(deterministic);
+    dMatcher.feed(word.begin(), word.end());
+    BOOST_CHECK( dMatcher.isDead() );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
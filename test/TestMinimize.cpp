@@ -0,0 +1,135 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Minimize.hpp"
+#include <memory>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// Compares both languages on every word up to maxLength
+template<unsigned int ALPHABET_SIZE>
+bool SameWords(DRegularLanguage<ALPHABET_SIZE> &expected, DRegularLanguage<ALPHABET_SIZE> &actual, unsigned int maxLength) {
+    vector<unsigned int> word;
+    for(unsigned int length = 0; length <= maxLength; length++) {
+        word.assign(length, 0);
+        while(true) {
+            if(expected.contains(word.begin(), word.end()) != actual.contains(word.begin(), word.end())) {
+                return false;
+            }
+            unsigned int position = 0;
+            while(position < length && ++word[position] == ALPHABET_SIZE) {
+                word[position++] = 0;
+            }
+            if(position == length) {
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_SUITE( TestMinimize );
+
+BOOST_AUTO_TEST_CASE( invalid_initial_state )
+{
+    DFA dfa;
+    auto result = Minimize(dfa, 0);
+    BOOST_CHECK( result.initialState == DFA::INVALID_STATE );
+    BOOST_CHECK( result.automaton.GetNumStates() == 0 );
+    BOOST_CHECK( result.mergedStates == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( merge_duplicate_states )
+{
+    // Thue morse with every state duplicated, the copies alternate on each 0
+    DFA *dfa = new DFA();
+    auto even1 = dfa->AddState(false);
+    auto odd1 = dfa->AddState(true);
+    auto even2 = dfa->AddState(false);
+    auto odd2 = dfa->AddState(true);
+    dfa->SetArc(even1, 0, even2);
+    dfa->SetArc(even2, 0, even1);
+    dfa->SetArc(odd1, 0, odd2);
+    dfa->SetArc(odd2, 0, odd1);
+    dfa->SetArc(even1, 1, odd1);
+    dfa->SetArc(even2, 1, odd2);
+    dfa->SetArc(odd1, 1, even2);
+    dfa->SetArc(odd2, 1, even1);
+    
+    auto result = Minimize(*dfa, even1);
+    BOOST_CHECK( result.automaton.GetNumStates() == 2 );
+    BOOST_CHECK( result.mergedStates == 2 );
+    BOOST_CHECK( result.unreachableStates == 0 );
+    BOOST_CHECK( result.initialState == 0 );
+    
+    DRegularLanguage<2> original(dfa, even1);
+    DRegularLanguage<2> minimized = Minimize(original);
+    BOOST_CHECK( SameWords(original, minimized, 8) );
+}
+
+BOOST_AUTO_TEST_CASE( drop_unreachable_and_dead_states )
+{
+    DAutomaton<3> *dfa = new DAutomaton<3>();
+    auto unreachable = dfa->AddState(true);
+    auto start = dfa->AddState(false);
+    auto accept = dfa->AddState(true);
+    auto dead = dfa->AddState(false);
+    dfa->SetArc(unreachable, 0, start);
+    dfa->SetArc(start, 1, accept);
+    dfa->SetArc(start, 2, dead);
+    dfa->SetArc(dead, 0, dead);
+    dfa->SetArc(accept, 0, start);
+    
+    auto result = Minimize(*dfa, start);
+    BOOST_CHECK( result.automaton.GetNumStates() == 2 );
+    BOOST_CHECK( result.unreachableStates == 1 );
+    BOOST_CHECK( result.mergedStates == 1 );
+    BOOST_CHECK( result.automaton.GetNext(result.initialState, 2) == DAutomaton<3>::INVALID_STATE );
+    
+    DRegularLanguage<3> original(dfa, start);
+    DRegularLanguage<3> minimized = Minimize(original);
+    BOOST_CHECK( SameWords(original, minimized, 6) );
+}
+
+BOOST_AUTO_TEST_CASE( no_final_states )
+{
+    DFA dfa;
+    auto state = dfa.AddState(false);
+    dfa.SetArc(state, 0, state);
+    dfa.SetArc(state, 1, state);
+    
+    auto result = Minimize(dfa, state);
+    BOOST_CHECK( result.initialState == DFA::INVALID_STATE );
+    BOOST_CHECK( result.automaton.GetNumStates() == 0 );
+    BOOST_CHECK( result.mergedStates == 1 );
+}
+
+BOOST_AUTO_TEST_CASE( mod_three_with_weights )
+{
+    // Accepts words whose value modulo 3 is 0, reading the least significant digit first.
+    // (r, 1) behaves like (2r mod 3, 2), so the six states collapse to three.
+    DFA *dfa = new DFA();
+    DFA::StateId states[6];
+    for(unsigned int i = 0; i < 6; i++) {
+        // (remainder, weight of the next digit) pairs, the weight alternates between 1 and 2
+        states[i] = dfa->AddState(i % 3 == 0);
+    }
+    for(unsigned int remainder = 0; remainder < 3; remainder++) {
+        dfa->SetArc(states[remainder], 0, states[3 + remainder]);
+        dfa->SetArc(states[remainder], 1, states[3 + (remainder + 1) % 3]);
+        dfa->SetArc(states[3 + remainder], 0, states[remainder]);
+        dfa->SetArc(states[3 + remainder], 1, states[(remainder + 2) % 3]);
+    }
+    
+    DRegularLanguage<2> original(dfa, states[0]);
+    DRegularLanguage<2> minimized = Minimize(original);
+    BOOST_CHECK( minimized.GetAutomaton()->GetNumStates() == 3 );
+    BOOST_CHECK( SameWords(original, minimized, 10) );
+    for(unsigned int number = 0; number < 100; number++) {
+        BOOST_CHECK( minimized.contains(number) == (number % 3 == 0) );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -108,4 +108,31 @@ BOOST_AUTO_TEST_CASE( add_parallel_states )
     BOOST_CHECK( std::distance(arcRange.begin(), arcRange.end()) == 2 );
 }
 
+BOOST_AUTO_TEST_CASE( freeze )
+{
+    NFA nfa;
+    NFA::StateId state1 = nfa.AddState(true);
+    NFA::StateId state2 = nfa.AddState(false);
+    
+    nfa.AddArc(state2,1,state1);
+    nfa.AddArc(state1,0,state2);
+    nfa.AddArc(state1,0,state1);
+    
+    BOOST_CHECK( !nfa.IsFrozen() );
+    nfa.Freeze();
+    BOOST_CHECK( nfa.IsFrozen() );
+    
+    AssertEquals( nfa.GetNext(state1,0), {state1, state2} );
+    AssertEquals( nfa.GetNext(state1,1), {} );
+    AssertEquals( nfa.GetNext(state2,0), {} );
+    AssertEquals( nfa.GetNext(state2,1), {state1} );
+    AssertEquals( nfa.GetNext(state2,2), {} );
+    AssertEquals( nfa.GetNext(NFA::INVALID_STATE,0), {} );
+    
+    // Modifying the automaton drops the index
+    nfa.AddArc(state2,0,state2);
+    BOOST_CHECK( !nfa.IsFrozen() );
+    AssertEquals( nfa.GetNext(state2,0), {state2} );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,129 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "NAutomatonBuilder.hpp"
+#include <set>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+static void AssertEquals(const NFA::ArcRange &range, std::multiset<NFA::StateId> expected) {
+    std::multiset<NFA::StateId> actual;
+    for(auto &arc : range) {
+        actual.insert(ArcDestination(arc));
+    }
+    BOOST_CHECK(actual == expected);
+}
+
+BOOST_AUTO_TEST_SUITE( TestNAutomatonBuilder )
+
+BOOST_AUTO_TEST_CASE( empty_builder )
+{
+    NFABuilder builder;
+    NFA nfa = builder.Freeze();
+    BOOST_CHECK( nfa.GetNumStates() == 0 );
+    AssertEquals( nfa.GetNext(0,0), {} );
+}
+
+BOOST_AUTO_TEST_CASE( arcs_in_any_order )
+{
+    NFABuilder builder;
+    NFA::StateId state1 = builder.AddState(true);
+    NFA::StateId state2 = builder.AddState(false);
+    NFA::StateId state3 = builder.AddState(true);
+    
+    builder.AddArc(state3,1,state1);
+    builder.AddArc(state1,0,state2);
+    builder.AddArc(state2,1,state3);
+    builder.AddArc(state1,0,state1);
+    builder.AddArc(state1,0,state2);
+    BOOST_CHECK( builder.GetNumArcs() == 5 );
+    
+    NFA nfa = builder.Freeze();
+    BOOST_CHECK( nfa.IsFrozen() );
+    BOOST_CHECK( nfa.GetNumStates() == 3 );
+    BOOST_CHECK( nfa.IsFinal(state1) );
+    BOOST_CHECK( !nfa.IsFinal(state2) );
+    BOOST_CHECK( nfa.IsFinal(state3) );
+    
+    AssertEquals( nfa.GetNext(state1,0), {state1, state2, state2} );
+    AssertEquals( nfa.GetNext(state1,1), {} );
+    AssertEquals( nfa.GetNext(state2,1), {state3} );
+    AssertEquals( nfa.GetNext(state3,1), {state1} );
+    
+    // The builder starts over after freezing
+    BOOST_CHECK( builder.GetNumStates() == 0 );
+    BOOST_CHECK( builder.GetNumArcs() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( frozen_automaton_accepts_more_arcs )
+{
+    NFABuilder builder;
+    NFA::StateId state1 = builder.AddState(false);
+    builder.AddArc(state1,1,state1);
+    
+    NFA nfa = builder.Freeze();
+    nfa.AddArc(state1,0,state1);
+    AssertEquals( nfa.GetNext(state1,0), {state1} );
+    AssertEquals( nfa.GetNext(state1,1), {state1} );
+}
+
+BOOST_AUTO_TEST_CASE( invalid_arc )
+{
+    NFABuilder builder;
+    NFA::StateId state1 = builder.AddState(true);
+    
+    BOOST_CHECK_THROW( builder.AddArc(state1+1,0,state1), std::out_of_range);
+    BOOST_CHECK_THROW( builder.AddArc(state1,0,state1+1), std::out_of_range);
+    BOOST_CHECK_THROW( builder.AddArc(state1,2,state1), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE( epsilon_arcs )
+{
+    NFABuilder builder;
+    NFA::StateId state1 = builder.AddState(false);
+    NFA::StateId state2 = builder.AddState(true);
+    
+    builder.AddEpsilonArc(state2, state1);
+    builder.AddEpsilonArc(state1, state2);
+    BOOST_CHECK( builder.GetNumEpsilonArcs() == 2 );
+    BOOST_CHECK_THROW( builder.AddEpsilonArc(state1, state2+1), std::out_of_range );
+    
+    NFA nfa = builder.Freeze();
+    BOOST_CHECK( nfa.HasEpsilonArcs() );
+    BOOST_CHECK( builder.GetNumEpsilonArcs() == 0 );
+    for(auto &arc : nfa.GetEpsilonNext(state1)) {
+        BOOST_CHECK( arc.second == state2 );
+    }
+    for(auto &arc : nfa.GetEpsilonNext(state2)) {
+        BOOST_CHECK( arc.second == state1 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( bulk_arcs )
+{
+    NFABuilder builder;
+    builder.Reserve(3, 4);
+    NFA::StateId first = builder.AddStates(3, false);
+    BOOST_CHECK( first == 0 );
+    BOOST_CHECK( builder.GetNumStates() == 3 );
+    
+    vector<NFABuilder::Arc> arcs = { {2, 1, 0}, {0, 0, 1}, {0, 0, 2}, {1, 1, 2} };
+    builder.AddArcs(arcs);
+    
+    // A bad batch is rejected as a whole
+    vector<NFABuilder::Arc> invalid = { {0, 1, 1}, {0, 1, 3} };
+    BOOST_CHECK_THROW( builder.AddArcs(invalid), std::out_of_range );
+    invalid = { {0, 1, 1}, {0, 2, 1} };
+    BOOST_CHECK_THROW( builder.AddArcs(invalid), std::out_of_range );
+    BOOST_CHECK( builder.GetNumArcs() == 4 );
+    
+    NFA nfa = builder.Freeze();
+    AssertEquals( nfa.GetNext(0,0), {1, 2} );
+    AssertEquals( nfa.GetNext(0,1), {} );
+    AssertEquals( nfa.GetNext(1,1), {2} );
+    AssertEquals( nfa.GetNext(2,1), {0} );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "NRegularLanguage.hpp"
+#include "TestAutomata.hpp"
 #include <memory>
 
 using namespace FACore;
@@ -115,4 +116,113 @@ BOOST_AUTO_TEST_CASE( thue_morse )
     BOOST_CHECK( InLanguage(thueMorseSequence, {1,0,0}) );
 }
 
+BOOST_AUTO_TEST_CASE( thue_morse_bit_parallel )
+{
+    NAutomaton<2> *thueMorseMachine = new NAutomaton<2>();
+    auto evenState = thueMorseMachine->AddState(false);
+    auto oddState = thueMorseMachine->AddState(true);
+    
+    thueMorseMachine->AddArc(evenState, 0, evenState);
+    thueMorseMachine->AddArc(evenState, 1, oddState);
+    thueMorseMachine->AddArc(oddState, 0, oddState);
+    thueMorseMachine->AddArc(oddState, 1, evenState);
+    
+    NRegularLanguage<2> thueMorseSequence(thueMorseMachine, evenState, SimulationMode::BitParallel);
+    BOOST_CHECK( thueMorseSequence.GetSimulationMode() == SimulationMode::BitParallel );
+    
+    for(unsigned int number = 0; number < 64; number++) {
+        BOOST_CHECK( thueMorseSequence.contains(number) == (__builtin_popcount(number) % 2 == 1) );
+    }
+    BOOST_CHECK( NotInLanguage(thueMorseSequence, {0,0} ));
+    BOOST_CHECK( InLanguage(thueMorseSequence, {0,1,0}) );
+    
+    // Labels outside of the alphabet are rejected
+    BOOST_CHECK( NotInLanguage(thueMorseSequence, {1,2}) );
+}
+
+BOOST_AUTO_TEST_CASE( bit_parallel_matches_state_set )
+{
+    typedef NAutomaton<3> Machine;
+    shared_ptr<Machine> machine = ThirdFromLastIsTwo();
+    
+    NRegularLanguage<3> stateSet(machine, {0});
+    NRegularLanguage<3> bitParallel(machine, {0}, SimulationMode::BitParallel);
+    
+    for(unsigned int number = 0; number < 3 * 3 * 3 * 3 * 3 * 3; number++) {
+        BOOST_CHECK( stateSet.contains(number) == bitParallel.contains(number) );
+    }
+    BOOST_CHECK( InLanguage(bitParallel, {2,0,1}) );
+    BOOST_CHECK( NotInLanguage(bitParallel, {2,0,1,1}) );
+    
+    NRegularLanguage<3> emptyBitParallel(shared_ptr<const Machine>(new Machine()), {0}, SimulationMode::BitParallel);
+    BOOST_CHECK( NotInLanguage(emptyBitParallel, {}) );
+    BOOST_CHECK( NotInLanguage(emptyBitParallel, {1}) );
+}
+
+BOOST_AUTO_TEST_CASE( lazy_dfa_matches_state_set )
+{
+    shared_ptr<NAutomaton<3> > machine = ThirdFromLastIsTwo();
+    
+    NRegularLanguage<3> stateSet(machine, {0});
+    NRegularLanguage<3> lazy(machine, {0}, SimulationMode::LazyDFA);
+    // The cache is built by the first query
+    BOOST_CHECK( lazy.GetCache() == nullptr );
+    
+    for(unsigned int number = 0; number < 3 * 3 * 3 * 3 * 3 * 3; number++) {
+        BOOST_CHECK( stateSet.contains(number) == lazy.contains(number) );
+    }
+    BOOST_CHECK( stateSet.GetCache() == nullptr );
+    BOOST_REQUIRE( lazy.GetCache() != nullptr );
+    BOOST_CHECK( NotInLanguage(lazy, {2,0,1,3}) );
+    
+    // All 8 subsets containing the start state were discovered, nothing was flushed
+    BOOST_CHECK( lazy.GetCache()->GetNumStates() == 8 );
+    BOOST_CHECK( lazy.GetCache()->GetNumFlushes() == 0 );
+    BOOST_CHECK( lazy.GetCache()->GetMemoryUsage() <= NRegularLanguage<3>::DEFAULT_CACHE_BUDGET );
+}
+
+BOOST_AUTO_TEST_CASE( lazy_dfa_flushes_when_full )
+{
+    shared_ptr<NAutomaton<3> > machine = ThirdFromLastIsTwo();
+    
+    // A budget this small only ever holds a single state
+    NRegularLanguage<3> stateSet(machine, {0});
+    NRegularLanguage<3> lazy(machine, {0}, SimulationMode::LazyDFA, 1);
+    
+    for(unsigned int number = 0; number < 3 * 3 * 3 * 3 * 3 * 3; number++) {
+        BOOST_CHECK( stateSet.contains(number) == lazy.contains(number) );
+    }
+    BOOST_CHECK( lazy.GetCache()->GetNumStates() == 1 );
+    BOOST_CHECK( lazy.GetCache()->GetNumFlushes() > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( epsilon_arcs_in_every_mode )
+{
+    // Words of the form 0* 1*, the zero loop reaches the one loop over an epsilon arc
+    typedef NAutomaton<2> Machine;
+    shared_ptr<Machine> machine( new Machine() );
+    auto zeros = machine->AddState(false);
+    auto ones = machine->AddState(true);
+    machine->AddArc(zeros, 0, zeros);
+    machine->AddArc(ones, 1, ones);
+    machine->AddEpsilonArc(zeros, ones);
+    
+    NRegularLanguage<2> stateSet(machine, {zeros});
+    NRegularLanguage<2> bitParallel(machine, {zeros}, SimulationMode::BitParallel);
+    NRegularLanguage<2> lazy(machine, {zeros}, SimulationMode::LazyDFA);
+    BOOST_CHECK( !stateSet.GetEpsilonClosure()->IsTrivial() );
+    
+    for(NRegularLanguage<2> *language : {&stateSet, &bitParallel, &lazy}) {
+        BOOST_CHECK( InLanguage(*language, {}) );
+        BOOST_CHECK( InLanguage(*language, {0,0,1}) );
+        BOOST_CHECK( InLanguage(*language, {1,1}) );
+        BOOST_CHECK( NotInLanguage(*language, {1,0}) );
+        BOOST_CHECK( NotInLanguage(*language, {0,1,0}) );
+    }
+    for(unsigned int number = 0; number < 256; number++) {
+        BOOST_CHECK( stateSet.contains(number) == bitParallel.contains(number) );
+        BOOST_CHECK( stateSet.contains(number) == lazy.contains(number) );
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
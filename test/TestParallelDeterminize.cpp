@@ -0,0 +1,91 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParallelDeterminize.hpp"
+#include "TestAutomata.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// Words whose kth symbol from the end is a 1, the textbook exponential blowup
+static NFA KthFromLast(unsigned int k) {
+    NFA nfa;
+    auto start = nfa.AddState(false);
+    nfa.AddArc(start, 0, start);
+    nfa.AddArc(start, 1, start);
+    auto previous = nfa.AddState(false);
+    nfa.AddArc(start, 1, previous);
+    for(unsigned int i = 1; i < k; i++) {
+        auto next = nfa.AddState(i + 1 == k);
+        nfa.AddArc(previous, 0, next);
+        nfa.AddArc(previous, 1, next);
+        previous = next;
+    }
+    return nfa;
+}
+
+BOOST_AUTO_TEST_SUITE( TestParallelDeterminize );
+
+BOOST_AUTO_TEST_CASE( empty_initial_set )
+{
+    NFA nfa;
+    nfa.AddState(true);
+    
+    auto result = ParallelDeterminize(nfa, {}, 2);
+    BOOST_CHECK( result.initialState == DFA::INVALID_STATE );
+    BOOST_CHECK( result.automaton.GetNumStates() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( same_numbering_as_determinize )
+{
+    NFA nfa = KthFromLast(8);
+    auto expected = Determinize(nfa, {0});
+    BOOST_CHECK( expected.automaton.GetNumStates() == 256 );
+    for(unsigned int threads : {1u, 2u, 4u, 0u}) {
+        auto actual = ParallelDeterminize(nfa, {0}, threads);
+        BOOST_CHECK( actual.initialState == expected.initialState );
+        BOOST_CHECK( SameAutomaton(expected.automaton, actual.automaton) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( random_automata_with_epsilon_arcs )
+{
+    mt19937 random(5);
+    for(unsigned int trial = 0; trial < 20; trial++) {
+        NFA nfa;
+        unsigned int numStates = 2 + random() % 12;
+        for(unsigned int state = 0; state < numStates; state++) {
+            nfa.AddState(random() % 4 == 0);
+        }
+        for(unsigned int arc = 0; arc < 4 * numStates; arc++) {
+            nfa.AddArc(random() % numStates, random() % 2, random() % numStates);
+        }
+        for(unsigned int arc = 0; arc < numStates / 2; arc++) {
+            nfa.AddEpsilonArc(random() % numStates, random() % numStates);
+        }
+        
+        auto expected = Determinize(nfa, {0, 1});
+        for(unsigned int threads : {1u, 2u, 4u}) {
+            auto actual = ParallelDeterminize(nfa, {0, 1}, threads);
+            BOOST_CHECK( actual.initialState == expected.initialState );
+            BOOST_CHECK( SameAutomaton(expected.automaton, actual.automaton) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( language_overload )
+{
+    shared_ptr<NFA> nfa( new NFA(KthFromLast(3)) );
+    NRegularLanguage<2> language(nfa, {0});
+    DRegularLanguage<2> determinized = ParallelDeterminize(language, 3);
+    
+    vector<unsigned int> accepted = {0, 1, 0, 0};
+    vector<unsigned int> rejected = {1, 0, 1, 0};
+    BOOST_CHECK( determinized.contains(accepted.begin(), accepted.end()) );
+    BOOST_CHECK( !determinized.contains(rejected.begin(), rejected.end()) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
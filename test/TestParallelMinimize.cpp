@@ -0,0 +1,151 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParallelMinimize.hpp"
+#include "TestAutomata.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+#include <chrono>
+
+using namespace FACore;
+using namespace std;
+
+template<unsigned int ALPHABET_SIZE>
+void CheckSameAsMinimize(const DAutomaton<ALPHABET_SIZE> &dfa, unsigned int initialState) {
+    auto expected = Minimize(dfa, initialState);
+    for(unsigned int threads : {1u, 2u, 4u}) {
+        auto actual = ParallelMinimize(dfa, initialState, threads);
+        BOOST_CHECK( actual.initialState == expected.initialState );
+        BOOST_CHECK( actual.mergedStates == expected.mergedStates );
+        BOOST_CHECK( actual.unreachableStates == expected.unreachableStates );
+        BOOST_CHECK( SameAutomaton(expected.automaton, actual.automaton) );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( TestParallelMinimize );
+
+BOOST_AUTO_TEST_CASE( invalid_initial_state )
+{
+    DFA dfa;
+    auto result = ParallelMinimize(dfa, 0, 2);
+    BOOST_CHECK( result.initialState == DFA::INVALID_STATE );
+    BOOST_CHECK( result.automaton.GetNumStates() == 0 );
+    BOOST_CHECK( result.mergedStates == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( unreachable_and_dead_states )
+{
+    DAutomaton<3> dfa;
+    auto unreachable = dfa.AddState(true);
+    auto start = dfa.AddState(false);
+    auto accept = dfa.AddState(true);
+    auto dead = dfa.AddState(false);
+    auto alsoDead = dfa.AddState(false);
+    dfa.SetArc(unreachable, 0, start);
+    dfa.SetArc(start, 1, accept);
+    dfa.SetArc(start, 2, dead);
+    dfa.SetArc(dead, 0, alsoDead);
+    dfa.SetArc(alsoDead, 0, dead);
+    dfa.SetArc(accept, 0, accept);
+    
+    auto result = ParallelMinimize(dfa, start, 2);
+    BOOST_CHECK( result.automaton.GetNumStates() == 2 );
+    BOOST_CHECK( result.mergedStates == 2 );
+    BOOST_CHECK( result.unreachableStates == 1 );
+    CheckSameAsMinimize(dfa, start);
+    
+    // Nothing accepted at all
+    auto empty = ParallelMinimize(dfa, dead, 2);
+    BOOST_CHECK( empty.initialState == DFA::INVALID_STATE );
+    BOOST_CHECK( empty.mergedStates == 2 );
+}
+
+BOOST_AUTO_TEST_CASE( long_refinement_chain )
+{
+    // Counting modulo 64 with a single final state takes many refinement rounds to settle
+    DFA dfa;
+    for(unsigned int state = 0; state < 128; state++) {
+        dfa.AddState(state % 64 == 0);
+    }
+    for(unsigned int state = 0; state < 128; state++) {
+        dfa.SetArc(state, 0, (state + 1) % 128);
+        dfa.SetArc(state, 1, state);
+    }
+    auto result = ParallelMinimize(dfa, 0, 4);
+    BOOST_CHECK( result.automaton.GetNumStates() == 64 );
+    CheckSameAsMinimize(dfa, 0);
+}
+
+BOOST_AUTO_TEST_CASE( long_chain_no_slower_than_minimize )
+{
+    // Only the last state is final, every state ends up in a block of its own
+    const unsigned int numStates = 20000;
+    DFA dfa;
+    for(unsigned int state = 0; state < numStates; state++) {
+        dfa.AddState(state + 1 == numStates);
+    }
+    for(unsigned int state = 0; state + 1 < numStates; state++) {
+        dfa.SetArc(state, 0, state + 1);
+        dfa.SetArc(state, 1, state + 1);
+    }
+    
+    auto start = chrono::steady_clock::now();
+    auto expected = Minimize(dfa, 0);
+    auto sequential = chrono::steady_clock::now() - start;
+    
+    start = chrono::steady_clock::now();
+    auto actual = ParallelMinimize(dfa, 0, 4);
+    auto parallel = chrono::steady_clock::now() - start;
+    
+    BOOST_CHECK( actual.automaton.GetNumStates() == numStates );
+    BOOST_CHECK( SameAutomaton(expected.automaton, actual.automaton) );
+    // Twice the time plus some slack, to stay clear of scheduling noise
+    BOOST_CHECK( parallel <= 2 * sequential + chrono::milliseconds(20) );
+}
+
+BOOST_AUTO_TEST_CASE( random_automata )
+{
+    mt19937 random(13);
+    for(unsigned int trial = 0; trial < 200; trial++) {
+        DAutomaton<3> dfa;
+        unsigned int numStates = 1 + random() % 300;
+        for(unsigned int state = 0; state < numStates; state++) {
+            dfa.AddState(random() % 3 == 0);
+        }
+        for(unsigned int state = 0; state < numStates; state++) {
+            for(unsigned int label = 0; label < 3; label++) {
+                if(random() % 5 != 0) {
+                    dfa.SetArc(state, label, random() % numStates);
+                }
+            }
+        }
+        CheckSameAsMinimize(dfa, random() % numStates);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( language_overload )
+{
+    shared_ptr<DFA> dfa( new DFA() );
+    auto even1 = dfa->AddState(false);
+    auto odd1 = dfa->AddState(true);
+    auto even2 = dfa->AddState(false);
+    auto odd2 = dfa->AddState(true);
+    dfa->SetArc(even1, 0, even2);
+    dfa->SetArc(even2, 0, even1);
+    dfa->SetArc(odd1, 0, odd2);
+    dfa->SetArc(odd2, 0, odd1);
+    dfa->SetArc(even1, 1, odd1);
+    dfa->SetArc(even2, 1, odd2);
+    dfa->SetArc(odd1, 1, even2);
+    dfa->SetArc(odd2, 1, even1);
+    
+    DRegularLanguage<2> minimized = ParallelMinimize(DRegularLanguage<2>(dfa, even1), 2);
+    BOOST_CHECK( minimized.GetAutomaton()->GetNumStates() == 2 );
+    vector<unsigned int> odd = {0, 1, 1, 0, 1};
+    vector<unsigned int> even = {1, 0, 1};
+    BOOST_CHECK( minimized.contains(odd.begin(), odd.end()) );
+    BOOST_CHECK( !minimized.contains(even.begin(), even.end()) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,112 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Product.hpp"
+#include "TestAutomata.hpp"
+#include <memory>
+#include <vector>
+#include <functional>
+
+using namespace FACore;
+using namespace std;
+
+static DRegularLanguage<2> EmptyLanguage() {
+    return DRegularLanguage<2>(new DFA(), 0);
+}
+
+// Calls check on every word up to maxLength
+static void ForAllWords(unsigned int maxLength, std::function<void(const vector<unsigned int>&)> check) {
+    vector<unsigned int> word;
+    for(unsigned int length = 0; length <= maxLength; length++) {
+        for(unsigned int bits = 0; bits < (1u << length); bits++) {
+            word.clear();
+            for(unsigned int position = 0; position < length; position++) {
+                word.push_back((bits >> position) & 1);
+            }
+            check(word);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( TestProduct );
+
+BOOST_AUTO_TEST_CASE( eager_operations )
+{
+    DRegularLanguage<2> odd = OddOnes();
+    DRegularLanguage<2> noDouble(NoTwoOnes(), 0);
+    
+    DRegularLanguage<2> intersection = Intersection(odd, noDouble);
+    DRegularLanguage<2> both = Union(odd, noDouble);
+    DRegularLanguage<2> difference = Difference(odd, noDouble);
+    DRegularLanguage<2> complement = Complement(noDouble);
+    
+    ForAllWords(8, [&](const vector<unsigned int> &word) {
+        bool inOdd = odd.contains(word.begin(), word.end());
+        bool inNoDouble = noDouble.contains(word.begin(), word.end());
+        BOOST_CHECK( intersection.contains(word.begin(), word.end()) == (inOdd && inNoDouble) );
+        BOOST_CHECK( both.contains(word.begin(), word.end()) == (inOdd || inNoDouble) );
+        BOOST_CHECK( difference.contains(word.begin(), word.end()) == (inOdd && !inNoDouble) );
+        BOOST_CHECK( complement.contains(word.begin(), word.end()) == !inNoDouble );
+    });
+    
+    // Only reachable pairs are built
+    BOOST_CHECK( intersection.GetAutomaton()->GetNumStates() == 4 );
+    
+    // The complement needs an explicit sink for the undefined arc
+    BOOST_CHECK( complement.GetAutomaton()->GetNumStates() == 3 );
+    BOOST_CHECK( Complement(odd).GetAutomaton()->GetNumStates() == 2 );
+}
+
+BOOST_AUTO_TEST_CASE( empty_operand )
+{
+    DRegularLanguage<2> odd = OddOnes();
+    DRegularLanguage<2> empty = EmptyLanguage();
+    
+    DRegularLanguage<2> intersection = Intersection(odd, empty);
+    DRegularLanguage<2> both = Union(empty, odd);
+    DRegularLanguage<2> difference = Difference(odd, empty);
+    DRegularLanguage<2> everything = Complement(empty);
+    
+    BOOST_CHECK( intersection.GetInitialState() == DFA::INVALID_STATE );
+    ForAllWords(6, [&](const vector<unsigned int> &word) {
+        bool inOdd = odd.contains(word.begin(), word.end());
+        BOOST_CHECK( !intersection.contains(word.begin(), word.end()) );
+        BOOST_CHECK( both.contains(word.begin(), word.end()) == inOdd );
+        BOOST_CHECK( difference.contains(word.begin(), word.end()) == inOdd );
+        BOOST_CHECK( everything.contains(word.begin(), word.end()) );
+    });
+}
+
+BOOST_AUTO_TEST_CASE( lazy_product )
+{
+    DRegularLanguage<2> odd = OddOnes();
+    DRegularLanguage<2> noDouble(NoTwoOnes(), 0);
+    
+    LazyProduct<2> intersection(odd, noDouble, ProductOperation::Intersection);
+    LazyProduct<2> difference(odd, noDouble, ProductOperation::Difference);
+    
+    // Holds a single pair, so nearly every step flushes
+    LazyProduct<2> tinyUnion(odd, noDouble, ProductOperation::Union, 1);
+    
+    ForAllWords(8, [&](const vector<unsigned int> &word) {
+        bool inOdd = odd.contains(word.begin(), word.end());
+        bool inNoDouble = noDouble.contains(word.begin(), word.end());
+        BOOST_CHECK( intersection.contains(word.begin(), word.end()) == (inOdd && inNoDouble) );
+        BOOST_CHECK( difference.contains(word.begin(), word.end()) == (inOdd && !inNoDouble) );
+        BOOST_CHECK( tinyUnion.contains(word.begin(), word.end()) == (inOdd || inNoDouble) );
+    });
+    
+    BOOST_CHECK( intersection.GetNumStates() == 4 );
+    BOOST_CHECK( intersection.GetNumFlushes() == 0 );
+    BOOST_CHECK( tinyUnion.GetNumStates() == 1 );
+    BOOST_CHECK( tinyUnion.GetNumFlushes() > 0 );
+    
+    for(unsigned int number = 0; number < 256; number++) {
+        BOOST_CHECK( intersection.contains(number) == (odd.contains(number) && noDouble.contains(number)) );
+    }
+    
+    std::vector<unsigned int> invalidWord {1, 2};
+    BOOST_CHECK( !intersection.contains(invalidWord.begin(), invalidWord.end()) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
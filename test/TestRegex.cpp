@@ -0,0 +1,194 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Regex.hpp"
+#include <string>
+#include <iterator>
+#include <vector>
+#include <stdexcept>
+
+using namespace FACore;
+using namespace std;
+
+// Words are written as strings of digits
+template<class LanguageType>
+bool Matches(LanguageType &language, const string &word) {
+    vector<unsigned int> labels;
+    for(char symbol : word) {
+        labels.push_back(symbol - '0');
+    }
+    return language.contains(labels.begin(), labels.end());
+}
+
+// Every binary word up to maxLength, least significant bit first
+static vector<string> BinaryWords(unsigned int maxLength) {
+    vector<string> words;
+    for(unsigned int length = 0; length <= maxLength; length++) {
+        for(unsigned int bits = 0; bits < (1u << length); bits++) {
+            string word;
+            for(unsigned int position = 0; position < length; position++) {
+                word += (bits >> position) & 1 ? '1' : '0';
+            }
+            words.push_back(word);
+        }
+    }
+    return words;
+}
+
+BOOST_AUTO_TEST_SUITE( TestRegex );
+
+BOOST_AUTO_TEST_CASE( operators )
+{
+    auto language = CompileRegex<2>("0(1|0)*1");
+    BOOST_CHECK( Matches(language, "01") );
+    BOOST_CHECK( Matches(language, "0101") );
+    BOOST_CHECK( !Matches(language, "0") );
+    BOOST_CHECK( !Matches(language, "10") );
+    BOOST_CHECK( !Matches(language, "0110") );
+    
+    auto plus = CompileRegex<2>("(01)+0?");
+    BOOST_CHECK( !Matches(plus, "") );
+    BOOST_CHECK( Matches(plus, "01") );
+    BOOST_CHECK( Matches(plus, "010") );
+    BOOST_CHECK( Matches(plus, "01010") );
+    BOOST_CHECK( !Matches(plus, "0100") );
+    
+    auto empty = CompileRegex<2>("");
+    BOOST_CHECK( Matches(empty, "") );
+    BOOST_CHECK( !Matches(empty, "0") );
+    
+    auto emptyBranch = CompileRegex<2>("(1|)0");
+    BOOST_CHECK( Matches(emptyBranch, "0") );
+    BOOST_CHECK( Matches(emptyBranch, "10") );
+    BOOST_CHECK( !Matches(emptyBranch, "1") );
+    
+    auto nestedStars = CompileRegex<2>("(0*1*)*");
+    for(const string &word : BinaryWords(6)) {
+        BOOST_CHECK( Matches(nestedStars, word) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( classes )
+{
+    // Decimal numbers without leading zeros, most significant digit first
+    auto decimal = CompileRegex<10>("0|[1-9][0-9]*");
+    BOOST_CHECK( decimal.containsNumber<DigitOrder::MostSignificantFirst>(1203u) );
+    BOOST_CHECK( Matches(decimal, "0") );
+    BOOST_CHECK( Matches(decimal, "1203") );
+    BOOST_CHECK( !Matches(decimal, "012") );
+    BOOST_CHECK( !Matches(decimal, "") );
+    
+    auto notZero = CompileRegex<10>("[^0]..");
+    BOOST_CHECK( Matches(notZero, "900") );
+    BOOST_CHECK( !Matches(notZero, "090") );
+    BOOST_CHECK( !Matches(notZero, "90") );
+    
+    auto listed = CompileRegex<10>("[13-57]");
+    BOOST_CHECK( Matches(listed, "1") && Matches(listed, "4") && Matches(listed, "7") );
+    BOOST_CHECK( !Matches(listed, "2") && !Matches(listed, "6") );
+    
+    // Letters and decimal labels reach past the digits
+    auto wide = CompileRegex<40>("z<39>[a<11>]");
+    vector<unsigned int> word = {35, 39, 11};
+    BOOST_CHECK( wide.contains(word.begin(), word.end()) );
+    word = {35, 39, 12};
+    BOOST_CHECK( !wide.contains(word.begin(), word.end()) );
+}
+
+BOOST_AUTO_TEST_CASE( bounded_repetition )
+{
+    auto exactly = CompileRegex<2>("1{3}");
+    BOOST_CHECK( Matches(exactly, "111") );
+    BOOST_CHECK( !Matches(exactly, "11") && !Matches(exactly, "1111") );
+    
+    auto between = CompileRegex<2>("(01){1,3}");
+    BOOST_CHECK( !Matches(between, "") );
+    BOOST_CHECK( Matches(between, "01") && Matches(between, "010101") );
+    BOOST_CHECK( !Matches(between, "01010101") );
+    
+    auto atLeast = CompileRegex<2>("0{2,}1");
+    BOOST_CHECK( !Matches(atLeast, "01") );
+    BOOST_CHECK( Matches(atLeast, "001") && Matches(atLeast, "000001") );
+    
+    auto never = CompileRegex<2>("1{0}0");
+    BOOST_CHECK( Matches(never, "0") && !Matches(never, "10") );
+    
+    auto optional = CompileRegex<2>("1{0,2}");
+    BOOST_CHECK( Matches(optional, "") && Matches(optional, "11") && !Matches(optional, "111") );
+}
+
+BOOST_AUTO_TEST_CASE( every_mode_agrees )
+{
+    const string pattern = "(0|1)*1(0|1){2}|0+";
+    auto stateSet = CompileRegex<2>(pattern);
+    auto bitParallel = CompileRegex<2>(pattern, SimulationMode::BitParallel);
+    auto lazy = CompileRegex<2>(pattern, SimulationMode::LazyDFA);
+    auto minimal = CompileMinimalRegex<2>(pattern);
+    
+    for(const string &word : BinaryWords(8)) {
+        bool expected = (word.size() >= 3 && word[word.size() - 3] == '1') || (!word.empty() && word.find('1') == string::npos);
+        BOOST_CHECK( Matches(stateSet, word) == expected );
+        BOOST_CHECK( Matches(bitParallel, word) == expected );
+        BOOST_CHECK( Matches(lazy, word) == expected );
+        BOOST_CHECK( Matches(minimal, word) == expected );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( minimal_automaton )
+{
+    // The second to last symbol is a 1
+    auto secondToLast = CompileMinimalRegex<2>("(0|1)*1(0|1)");
+    BOOST_CHECK( secondToLast.GetAutomaton()->GetNumStates() == 4 );
+    
+    auto everything = CompileMinimalRegex<2>("(0*|1)*");
+    BOOST_CHECK( everything.GetAutomaton()->GetNumStates() == 1 );
+    
+    auto nothing = CompileMinimalRegex<2>("[^01]");
+    BOOST_CHECK( !Matches(nothing, "") && !Matches(nothing, "0") );
+}
+
+BOOST_AUTO_TEST_CASE( linear_size )
+{
+    // Nested operators add a constant number of states each
+    string nested = "0";
+    for(unsigned int depth = 0; depth < 200; depth++) {
+        nested = "(" + nested + ")+";
+    }
+    auto deep = RegexToNAutomaton<2>(nested);
+    BOOST_CHECK( deep.automaton.GetNumStates() <= 2 + 2 * 200 );
+    
+    auto repeated = RegexToNAutomaton<2>("(0|1){0,500}");
+    BOOST_CHECK( repeated.automaton.GetNumStates() <= 2 + 500 );
+    unsigned int arcs = 0;
+    for(NFA::StateId state = 0; state < repeated.automaton.GetNumStates(); state++) {
+        for(unsigned int label = 0; label < 2; label++) {
+            auto range = repeated.automaton.GetNext(state, label);
+            arcs += std::distance(range.begin(), range.end());
+        }
+    }
+    BOOST_CHECK( arcs == 2 * 500 );
+}
+
+BOOST_AUTO_TEST_CASE( expanded_size_and_depth_limits )
+{
+    // Nested bounds multiply, each count alone is within REGEX_MAX_REPETITION
+    BOOST_CHECK_THROW( RegexToNAutomaton<2>("(0{1000}){1000}"), std::invalid_argument );
+    BOOST_CHECK_THROW( RegexToNAutomaton<2>("((0{1000}){1000}){1000}"), std::invalid_argument );
+    BOOST_CHECK_THROW( RegexToNAutomaton<2>("(0{400}){300,}"), std::invalid_argument );
+    BOOST_CHECK( RegexToNAutomaton<2>("(0{100}){100}").automaton.GetNumStates() > 10000 );
+    
+    BOOST_CHECK_THROW( RegexToNAutomaton<2>(string(200000, '(')), std::invalid_argument );
+    BOOST_CHECK_THROW( RegexToNAutomaton<2>(string(200000, '(') + "0" + string(200000, ')')), std::invalid_argument );
+    BOOST_CHECK_THROW( RegexToNAutomaton<2>("0" + string(200000, '*')), std::invalid_argument );
+    BOOST_CHECK( RegexToNAutomaton<2>(string(500, '(') + "0" + string(500, ')')).automaton.GetNumStates() == 2 );
+}
+
+BOOST_AUTO_TEST_CASE( syntax_errors )
+{
+    const vector<string> invalid = {"(0", "0)", "*", "0|*", "[1-0]", "[0", "2", "<2>", "<>", "0{3,1}", "0{", "0{1001}", "A"};
+    for(const string &pattern : invalid) {
+        BOOST_CHECK_THROW( RegexToNAutomaton<2>(pattern), std::invalid_argument );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,132 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "RemoveEpsilons.hpp"
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// (0|1)* 1 followed by an optional 0, written with epsilon arcs in the style of Thompson's construction
+static shared_ptr<NFA> EndsWithOneMachine() {
+    shared_ptr<NFA> nfa( new NFA() );
+    auto loop = nfa->AddState(false);
+    auto zero = nfa->AddState(false);
+    auto one = nfa->AddState(false);
+    auto seenOne = nfa->AddState(false);
+    auto optional = nfa->AddState(false);
+    auto done = nfa->AddState(true);
+    nfa->AddEpsilonArc(loop, zero);
+    nfa->AddEpsilonArc(loop, one);
+    nfa->AddArc(zero, 0, loop);
+    nfa->AddArc(one, 1, loop);
+    nfa->AddArc(loop, 1, seenOne);
+    nfa->AddEpsilonArc(seenOne, optional);
+    nfa->AddEpsilonArc(seenOne, done);
+    nfa->AddArc(optional, 0, done);
+    return nfa;
+}
+
+static bool EndsWithOne(unsigned int word, unsigned int length) {
+    if(length == 0) {
+        return false;
+    }
+    unsigned int last = (word >> (length - 1)) & 1;
+    if(last == 1) {
+        return true;
+    }
+    return length >= 2 && ((word >> (length - 2)) & 1) == 1;
+}
+
+static set<NFA::StateId> ClosureOf(const EpsilonClosure<NFA> &closure, NFA::StateId state) {
+    set<NFA::StateId> result;
+    for(NFA::StateId member : closure.GetClosure(state)) {
+        BOOST_CHECK( result.insert(member).second );
+    }
+    return result;
+}
+
+BOOST_AUTO_TEST_SUITE( TestRemoveEpsilons );
+
+BOOST_AUTO_TEST_CASE( closures )
+{
+    NFA nfa;
+    for(unsigned int state = 0; state < 5; state++) {
+        nfa.AddState(false);
+    }
+    BOOST_CHECK( EpsilonClosure<NFA>(nfa).IsTrivial() );
+    
+    // A cycle 0 -> 1 -> 2 -> 0 with a tail 2 -> 3, state 4 stands alone
+    nfa.AddEpsilonArc(0, 1);
+    nfa.AddEpsilonArc(1, 2);
+    nfa.AddEpsilonArc(2, 0);
+    nfa.AddEpsilonArc(2, 3);
+    nfa.AddEpsilonArc(2, 3);
+    BOOST_CHECK( nfa.GetNumEpsilonArcs() == 5 );
+    
+    EpsilonClosure<NFA> closure(nfa);
+    BOOST_CHECK( !closure.IsTrivial() );
+    BOOST_CHECK( *closure.GetClosure(1).begin() == 1 );
+    BOOST_CHECK( ClosureOf(closure, 0) == set<NFA::StateId>({0, 1, 2, 3}) );
+    BOOST_CHECK( ClosureOf(closure, 1) == set<NFA::StateId>({0, 1, 2, 3}) );
+    BOOST_CHECK( ClosureOf(closure, 3) == set<NFA::StateId>({3}) );
+    BOOST_CHECK( ClosureOf(closure, 4) == set<NFA::StateId>({4}) );
+    
+    EpsilonClosure<NFA>::Subset subset(5);
+    subset.set(3);
+    subset.set(1);
+    closure.Close(subset);
+    BOOST_CHECK( subset.count() == 4 && !subset[4] );
+    
+    BOOST_CHECK_THROW( nfa.AddEpsilonArc(0, 5), std::out_of_range );
+    BOOST_CHECK_THROW( nfa.AddEpsilonArc(5, 0), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( removal_keeps_language )
+{
+    shared_ptr<NFA> nfa = EndsWithOneMachine();
+    NFA removed = RemoveEpsilons(*nfa);
+    BOOST_CHECK( !removed.HasEpsilonArcs() );
+    BOOST_CHECK( removed.IsFrozen() );
+    BOOST_CHECK( removed.GetNumStates() == nfa->GetNumStates() );
+    // The closure of seenOne holds the final state
+    BOOST_CHECK( removed.IsFinal(3) );
+    
+    NRegularLanguage<2> language(nfa, {0});
+    NRegularLanguage<2> withoutEpsilons = RemoveEpsilons(language);
+    BOOST_CHECK( !withoutEpsilons.GetAutomaton()->HasEpsilonArcs() );
+    for(unsigned int length = 0; length <= 8; length++) {
+        for(unsigned int word = 0; word < (1u << length); word++) {
+            vector<unsigned int> letters;
+            for(unsigned int position = 0; position < length; position++) {
+                letters.push_back((word >> position) & 1);
+            }
+            BOOST_CHECK( language.contains(letters.begin(), letters.end()) == EndsWithOne(word, length) );
+            BOOST_CHECK( withoutEpsilons.contains(letters.begin(), letters.end()) == EndsWithOne(word, length) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( removal_merges_parallel_arcs )
+{
+    NFA nfa;
+    auto start = nfa.AddState(false);
+    auto middle = nfa.AddState(false);
+    auto done = nfa.AddState(true);
+    nfa.AddEpsilonArc(start, middle);
+    nfa.AddArc(start, 1, done);
+    nfa.AddArc(middle, 1, done);
+    
+    NFA removed = RemoveEpsilons(nfa);
+    unsigned int arcs = 0;
+    for(auto &arc : removed.GetNext(start, 1)) {
+        BOOST_CHECK( ArcDestination(arc) == done );
+        arcs++;
+    }
+    BOOST_CHECK( arcs == 1 );
+    BOOST_CHECK( !removed.IsFinal(start) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,170 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DRegularLanguage.hpp"
+#include "NRegularLanguage.hpp"
+#include "TestAutomata.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+// Offsets at which some substring of the input ends that the language contains
+template<class LanguageType>
+vector<size_t> BruteForceScan(LanguageType &language, const vector<unsigned int> &input) {
+    vector<size_t> offsets;
+    for(size_t end = 0; end <= input.size(); end++) {
+        for(size_t begin = 0; begin <= end; begin++) {
+            if(language.contains(input.begin() + begin, input.begin() + end)) {
+                offsets.push_back(end);
+                break;
+            }
+        }
+    }
+    return offsets;
+}
+
+template<class LanguageType>
+vector<size_t> Scan(LanguageType &language, const vector<unsigned int> &input) {
+    vector<size_t> offsets;
+    language.scan(input.begin(), input.end(), [&](size_t offset) { offsets.push_back(offset); });
+    return offsets;
+}
+
+static vector<unsigned int> RandomWord(mt19937 &random, unsigned int numLabels, size_t maxLength) {
+    vector<unsigned int> word(random() % (maxLength + 1));
+    for(unsigned int &label : word) {
+        label = random() % numLabels;
+    }
+    return word;
+}
+
+// Exactly the word 1 0 1
+static shared_ptr<DFA> OneZeroOne() {
+    shared_ptr<DFA> dfa( new DFA() );
+    auto start = dfa->AddState(false);
+    auto one = dfa->AddState(false);
+    auto oneZero = dfa->AddState(false);
+    auto oneZeroOne = dfa->AddState(true);
+    dfa->SetArc(start, 1, one);
+    dfa->SetArc(one, 0, oneZero);
+    dfa->SetArc(oneZero, 1, oneZeroOne);
+    return dfa;
+}
+
+// 0 (1 | 2)* 2 over three labels, the loop goes through an epsilon arc
+static shared_ptr<NAutomaton<3> > ZeroThenEndsInTwo() {
+    shared_ptr<NAutomaton<3> > nfa( new NAutomaton<3>() );
+    auto start = nfa->AddState(false);
+    auto loop = nfa->AddState(false);
+    auto back = nfa->AddState(false);
+    auto end = nfa->AddState(true);
+    nfa->AddArc(start, 0, loop);
+    nfa->AddArc(loop, 1, back);
+    nfa->AddArc(loop, 2, back);
+    nfa->AddEpsilonArc(back, loop);
+    nfa->AddArc(loop, 2, end);
+    return nfa;
+}
+
+BOOST_AUTO_TEST_SUITE( TestScanner );
+
+BOOST_AUTO_TEST_CASE( dfa_matches_brute_force )
+{
+    DRegularLanguage<2> language(OneZeroOne(), 0);
+    
+    vector<unsigned int> input = {0, 1, 0, 1, 0, 1, 1, 0, 1};
+    BOOST_CHECK( Scan(language, input) == vector<size_t>({4, 6, 9}) );
+    
+    mt19937 random(5);
+    for(unsigned int trial = 0; trial < 300; trial++) {
+        vector<unsigned int> word = RandomWord(random, 2, 40);
+        BOOST_CHECK( Scan(language, word) == BruteForceScan(language, word) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( nfa_matches_brute_force )
+{
+    for(SimulationMode mode : {SimulationMode::StateSet, SimulationMode::BitParallel, SimulationMode::LazyDFA}) {
+        NRegularLanguage<3> language(ZeroThenEndsInTwo(), {0}, mode);
+        
+        vector<unsigned int> input = {2, 0, 2, 1, 2, 0, 0, 1};
+        BOOST_CHECK( Scan(language, input) == vector<size_t>({3, 5}) );
+        
+        mt19937 random(7);
+        for(unsigned int trial = 0; trial < 200; trial++) {
+            vector<unsigned int> word = RandomWord(random, 3, 30);
+            BOOST_CHECK( Scan(language, word) == BruteForceScan(language, word) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( invalid_labels_restart )
+{
+    DRegularLanguage<2> language(OneZeroOne(), 0);
+    BOOST_CHECK( Scan(language, {1, 0, 7, 1, 1, 0, 1}) == vector<size_t>({7}) );
+    
+    NRegularLanguage<3> nfaLanguage(ZeroThenEndsInTwo(), {0});
+    BOOST_CHECK( Scan(nfaLanguage, {0, 1, 3, 2, 0, 2}) == vector<size_t>({6}) );
+    
+    mt19937 random(11);
+    for(unsigned int trial = 0; trial < 200; trial++) {
+        vector<unsigned int> word = RandomWord(random, 4, 30);
+        BOOST_CHECK( Scan(nfaLanguage, word) == BruteForceScan(nfaLanguage, word) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( empty_word )
+{
+    DRegularLanguage<2> language(NoTwoOnes(), 0);
+    BOOST_CHECK( Scan(language, {}) == vector<size_t>({0}) );
+    BOOST_CHECK( Scan(language, {1, 1, 5, 0}) == vector<size_t>({0, 1, 2, 3, 4}) );
+}
+
+BOOST_AUTO_TEST_CASE( empty_language )
+{
+    DRegularLanguage<2> language(new DFA(), 0);
+    BOOST_CHECK( Scan(language, {0, 1, 1}).empty() );
+    
+    NRegularLanguage<2> nfaLanguage(new NFA(), 0);
+    BOOST_CHECK( Scan(nfaLanguage, {}).empty() );
+    BOOST_CHECK( Scan(nfaLanguage, {0, 1, 1}).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( long_input_skips_start )
+{
+    DRegularLanguage<2> language(OneZeroOne(), 0);
+    
+    vector<unsigned int> input(100000, 0);
+    input[500] = 1;
+    input[501] = 0;
+    input[502] = 1;
+    input[90000] = 1;
+    BOOST_CHECK( Scan(language, input) == vector<size_t>({503}) );
+    
+    // Zeros keep the search at its start, only the ones need the cache
+    Scanner<2> scanner(*OneZeroOne(), 0);
+    size_t count = 0;
+    scanner.scan(input.begin(), input.end(), [&](size_t) { count++; });
+    BOOST_CHECK( count == 1 );
+    BOOST_CHECK( scanner.GetCache().GetNumMisses() < 10 );
+}
+
+BOOST_AUTO_TEST_CASE( small_cache_budget )
+{
+    NRegularLanguage<3> language(ZeroThenEndsInTwo(), {0});
+    Scanner<3> scanner(*ZeroThenEndsInTwo(), {0}, 1);
+    
+    mt19937 random(13);
+    for(unsigned int trial = 0; trial < 100; trial++) {
+        vector<unsigned int> word = RandomWord(random, 3, 30);
+        vector<size_t> offsets;
+        scanner.scan(word.begin(), word.end(), [&](size_t offset) { offsets.push_back(offset); });
+        BOOST_CHECK( offsets == BruteForceScan(language, word) );
+    }
+    BOOST_CHECK( scanner.GetCache().GetNumFlushes() > 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
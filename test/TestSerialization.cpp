@@ -0,0 +1,203 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Serialization.hpp"
+#include "TestAutomata.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+using namespace FACore;
+using namespace std;
+
+// A partial automaton over three letters, with some undefined arcs
+static DAutomaton<3> PartialMachine() {
+    DAutomaton<3> machine;
+    for(unsigned int state = 0; state < 70; state++) {
+        machine.AddState(state % 3 == 1);
+    }
+    for(unsigned int state = 0; state < 70; state++) {
+        machine.SetArc(state, 0, (state + 1) % 70);
+        machine.SetArc(state, 2, (state * 7) % 70);
+    }
+    return machine;
+}
+
+BOOST_AUTO_TEST_SUITE( TestSerialization );
+
+BOOST_AUTO_TEST_CASE( dautomaton_round_trip )
+{
+    DAutomaton<3> machine = PartialMachine();
+    stringstream stream;
+    SaveAutomaton(machine, stream);
+    
+    DAutomaton<3> loaded = LoadDAutomaton<3>(stream);
+    BOOST_CHECK( SameAutomaton(machine, loaded) );
+    BOOST_CHECK( loaded.GetNext(5, 1) == DAutomaton<3>::INVALID_STATE );
+    
+    // Narrow ids round trip too
+    DAutomaton<2, uint8_t> narrow;
+    narrow.AddState(true);
+    narrow.SetArc(0, 1, 0);
+    stringstream narrowStream;
+    SaveAutomaton(narrow, narrowStream);
+    BOOST_CHECK(( SameAutomaton(narrow, LoadDAutomaton<2, uint8_t>(narrowStream)) ));
+}
+
+BOOST_AUTO_TEST_CASE( nautomaton_round_trip )
+{
+    NFA nfa;
+    auto start = nfa.AddState(false);
+    auto seenOne = nfa.AddState(false);
+    auto done = nfa.AddState(true);
+    nfa.AddArc(start, 0, start);
+    nfa.AddArc(start, 1, start);
+    nfa.AddArc(start, 1, seenOne);
+    nfa.AddArc(seenOne, 0, done);
+    nfa.AddArc(seenOne, 1, done);
+    
+    stringstream stream;
+    SaveAutomaton(nfa, stream);
+    NFA loaded = LoadNAutomaton<2>(stream);
+    
+    BOOST_CHECK( loaded.IsFrozen() );
+    BOOST_CHECK( loaded.GetNumStates() == 3 );
+    BOOST_CHECK( loaded.IsFinal(done) && !loaded.IsFinal(start) );
+    for(NFA::StateId state = 0; state < 3; state++) {
+        for(unsigned int label = 0; label < 2; label++) {
+            vector<NFA::StateId> expected, actual;
+            for(auto &arc : nfa.GetNext(state, label)) {
+                expected.push_back(ArcDestination(arc));
+            }
+            for(auto &arc : loaded.GetNext(state, label)) {
+                actual.push_back(ArcDestination(arc));
+            }
+            BOOST_CHECK( expected == actual );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( nautomaton_epsilon_round_trip )
+{
+    NFA nfa;
+    auto start = nfa.AddState(false);
+    auto middle = nfa.AddState(false);
+    auto done = nfa.AddState(true);
+    nfa.AddArc(start, 1, middle);
+    nfa.AddEpsilonArc(start, middle);
+    nfa.AddEpsilonArc(middle, done);
+    nfa.AddEpsilonArc(middle, start);
+    
+    stringstream stream;
+    SaveAutomaton(nfa, stream);
+    string bytes = stream.str();
+    NFA loaded = LoadNAutomaton<2>(stream);
+    
+    BOOST_CHECK( loaded.GetNumEpsilonArcs() == 3 );
+    for(NFA::StateId state = 0; state < 3; state++) {
+        vector<NFA::StateId> expected, actual;
+        for(auto &arc : nfa.GetEpsilonNext(state)) {
+            expected.push_back(arc.second);
+        }
+        for(auto &arc : loaded.GetEpsilonNext(state)) {
+            actual.push_back(arc.second);
+        }
+        BOOST_CHECK( expected == actual );
+    }
+    
+    // A version 1 file is the same without the epsilon section
+    NFA plain;
+    plain.AddState(true);
+    plain.AddArc(0, 1, 0);
+    stringstream plainStream;
+    SaveAutomaton(plain, plainStream);
+    string plainBytes = plainStream.str();
+    // Two offsets and no destinations
+    plainBytes.resize(plainBytes.size() - 2 * sizeof(uint64_t));
+    uint32_t version = 1;
+    plainBytes.replace(offsetof(AutomatonFileHeader, version), sizeof(version), reinterpret_cast<const char*>(&version), sizeof(version));
+    stringstream oldStream(plainBytes);
+    NFA old = LoadNAutomaton<2>(oldStream);
+    BOOST_CHECK( old.GetNumStates() == 1 && old.IsFinal(0) );
+    BOOST_CHECK( old.GetNumEpsilonArcs() == 0 );
+    
+    version = AUTOMATON_FORMAT_VERSION + 1;
+    plainBytes.replace(offsetof(AutomatonFileHeader, version), sizeof(version), reinterpret_cast<const char*>(&version), sizeof(version));
+    stringstream newerStream(plainBytes);
+    BOOST_CHECK_THROW( LoadNAutomaton<2>(newerStream), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( rejects_other_automata )
+{
+    stringstream stream;
+    SaveAutomaton(PartialMachine(), stream);
+    string bytes = stream.str();
+    
+    stringstream otherAlphabet(bytes);
+    BOOST_CHECK_THROW( LoadDAutomaton<2>(otherAlphabet), std::runtime_error );
+    
+    stringstream otherWidth(bytes);
+    BOOST_CHECK_THROW( (LoadDAutomaton<3, uint16_t>(otherWidth)), std::runtime_error );
+    
+    stringstream otherKind(bytes);
+    BOOST_CHECK_THROW( LoadNAutomaton<3>(otherKind), std::runtime_error );
+    
+    stringstream truncated(bytes.substr(0, bytes.size() - 8));
+    BOOST_CHECK_THROW( LoadDAutomaton<3>(truncated), std::runtime_error );
+    
+    stringstream garbage(string(100, 'x'));
+    BOOST_CHECK_THROW( LoadDAutomaton<3>(garbage), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( rejects_invalid_destinations )
+{
+    stringstream stream;
+    SaveAutomaton(PartialMachine(), stream);
+    string bytes = stream.str();
+    
+    // Point the first arc past the last state
+    unsigned int outOfRange = 70;
+    bytes.replace(sizeof(AutomatonFileHeader), sizeof(outOfRange), reinterpret_cast<const char*>(&outOfRange), sizeof(outOfRange));
+    stringstream corrupted(bytes);
+    BOOST_CHECK_THROW( LoadDAutomaton<3>(corrupted), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( corrupt_sizes_do_not_allocate )
+{
+    // Headers alone, claiming sections far larger than the stream
+    AutomatonFileHeader header = MakeAutomatonFileHeader(AutomatonKind::Deterministic, 3, sizeof(unsigned int), 1u << 31, 0);
+    stringstream manyStates(string(reinterpret_cast<const char*>(&header), sizeof(header)));
+    BOOST_CHECK_THROW( LoadDAutomaton<3>(manyStates), std::runtime_error );
+    
+    header = MakeAutomatonFileHeader(AutomatonKind::Nondeterministic, 3, sizeof(unsigned int), 1u << 31, 0);
+    stringstream manyOffsets(string(reinterpret_cast<const char*>(&header), sizeof(header)));
+    BOOST_CHECK_THROW( LoadNAutomaton<3>(manyOffsets), std::runtime_error );
+    
+    // Consistent offsets that announce 2^40 arcs
+    header = MakeAutomatonFileHeader(AutomatonKind::Nondeterministic, 3, sizeof(unsigned int), 1, uint64_t(1) << 40);
+    vector<uint64_t> offsets = {0, 0, 0, uint64_t(1) << 40};
+    string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    stringstream manyArcs(bytes);
+    BOOST_CHECK_THROW( LoadNAutomaton<3>(manyArcs), std::runtime_error );
+    
+    // Epsilon offsets that announce 2^40 epsilon arcs
+    header = MakeAutomatonFileHeader(AutomatonKind::Nondeterministic, 3, sizeof(unsigned int), 1, 0);
+    offsets = {0, 0, 0, 0};
+    vector<uint64_t> finalWords = {0};
+    vector<uint64_t> epsilonOffsets = {0, uint64_t(1) << 40};
+    bytes.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    bytes.append(reinterpret_cast<const char*>(finalWords.data()), finalWords.size() * sizeof(uint64_t));
+    bytes.append(reinterpret_cast<const char*>(epsilonOffsets.data()), epsilonOffsets.size() * sizeof(uint64_t));
+    stringstream manyEpsilonArcs(bytes);
+    BOOST_CHECK_THROW( LoadNAutomaton<3>(manyEpsilonArcs), std::runtime_error );
+    
+    // 64 bit state ids, the offset count itself would overflow
+    header = MakeAutomatonFileHeader(AutomatonKind::Nondeterministic, 3, sizeof(uint64_t), uint64_t(1) << 63, 0);
+    stringstream overflow(string(reinterpret_cast<const char*>(&header), sizeof(header)));
+    BOOST_CHECK_THROW( (LoadNAutomaton<3, uint64_t>(overflow)), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
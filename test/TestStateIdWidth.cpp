@@ -0,0 +1,115 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "StateIdWidth.hpp"
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+using namespace FACore;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE( TestStateIdWidth );
+
+BOOST_AUTO_TEST_CASE( compact_state_id_selection )
+{
+    BOOST_CHECK(( is_same<CompactStateId<10>::type, uint8_t>::value ));
+    BOOST_CHECK(( is_same<CompactStateId<254>::type, uint8_t>::value ));
+    // States 0 to 254 leave 255 for INVALID_STATE
+    BOOST_CHECK(( is_same<CompactStateId<255>::type, uint8_t>::value ));
+    BOOST_CHECK(( is_same<CompactStateId<256>::type, uint16_t>::value ));
+    BOOST_CHECK(( is_same<CompactStateId<65535>::type, uint16_t>::value ));
+    BOOST_CHECK(( is_same<CompactStateId<65536>::type, uint32_t>::value ));
+    BOOST_CHECK(( is_same<CompactStateId<0xffffffffull>::type, uint32_t>::value ));
+    BOOST_CHECK(( is_same<CompactStateId<0x100000000ull>::type, uint64_t>::value ));
+    BOOST_CHECK(( is_same<CompactStateId<5000000000ull>::type, uint64_t>::value ));
+    
+    BOOST_CHECK(( sizeof(CompactDAutomaton<2, 200>::TransitionArr) == 2 ));
+    BOOST_CHECK(( sizeof(CompactDAutomaton<10, 1000>::TransitionArr) == 20 ));
+    BOOST_CHECK(( CompactDAutomaton<2, 200>::INVALID_STATE == 255 ));
+    BOOST_CHECK(( sizeof(CompactDAutomaton<2, 255>::TransitionArr) == 2 ));
+}
+
+BOOST_AUTO_TEST_CASE( narrow_automaton_limits )
+{
+    DAutomaton<2, uint8_t> dfa;
+    for(unsigned int i = 0; i < 255; i++) {
+        dfa.AddState(false);
+    }
+    // 255 is INVALID_STATE
+    BOOST_CHECK_THROW( dfa.AddState(false), std::out_of_range );
+    BOOST_CHECK( dfa.GetNumStates() == 255 );
+    
+    dfa.SetArc(254, 1, 0);
+    BOOST_CHECK( dfa.GetNext(254, 1) == 0 );
+    BOOST_CHECK( dfa.GetNext(254, 0) == dfa.INVALID_STATE );
+    BOOST_CHECK( dfa.GetNext(255, 0) == dfa.INVALID_STATE );
+    
+    NAutomaton<2, uint8_t> nfa;
+    for(unsigned int i = 0; i < 255; i++) {
+        nfa.AddState(false);
+    }
+    BOOST_CHECK_THROW( nfa.AddState(false), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( convert_dautomaton )
+{
+    DFA dfa;
+    auto evenState = dfa.AddState(false);
+    auto oddState = dfa.AddState(true);
+    dfa.SetArc(evenState, 0, evenState);
+    dfa.SetArc(evenState, 1, oddState);
+    dfa.SetArc(oddState, 1, evenState);
+    
+    DAutomaton<2, uint8_t> narrow = ConvertStateWidth<uint8_t>(dfa);
+    BOOST_CHECK( narrow.GetNumStates() == 2 );
+    BOOST_CHECK( narrow.IsFinal(oddState) );
+    BOOST_CHECK( narrow.GetNext(evenState, 1) == oddState );
+    BOOST_CHECK( narrow.GetNext(oddState, 0) == narrow.INVALID_STATE );
+    
+    DFA wide = ConvertStateWidth<unsigned int>(narrow);
+    BOOST_CHECK( wide.GetNext(oddState, 0) == DFA::INVALID_STATE );
+    BOOST_CHECK( wide.GetNext(oddState, 1) == evenState );
+    
+    BOOST_CHECK( ConvertStateId<uint8_t>(DFA::INVALID_STATE) == 255 );
+    BOOST_CHECK( ConvertStateId<unsigned int>(uint8_t(255)) == DFA::INVALID_STATE );
+    BOOST_CHECK_THROW( ConvertStateId<uint8_t>(300u), std::out_of_range );
+    
+    DFA large;
+    for(unsigned int i = 0; i < 256; i++) {
+        large.AddState(false);
+    }
+    BOOST_CHECK_THROW( ConvertStateWidth<uint8_t>(large), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( convert_languages )
+{
+    DFA *dfa = new DFA();
+    auto evenState = dfa->AddState(false);
+    auto oddState = dfa->AddState(true);
+    dfa->SetArc(evenState, 0, evenState);
+    dfa->SetArc(evenState, 1, oddState);
+    dfa->SetArc(oddState, 0, oddState);
+    dfa->SetArc(oddState, 1, evenState);
+    DRegularLanguage<2> language(dfa, evenState);
+    DRegularLanguage<2, uint8_t> narrow = ConvertStateWidth<uint8_t>(language);
+    
+    NFA *nfa = new NFA();
+    auto start = nfa->AddState(false);
+    auto last = nfa->AddState(true);
+    nfa->AddArc(start, 0, start);
+    nfa->AddArc(start, 1, start);
+    nfa->AddArc(start, 1, last);
+    NRegularLanguage<2> endsInOne(nfa, start, SimulationMode::BitParallel);
+    NRegularLanguage<2, uint16_t> narrowEndsInOne = ConvertStateWidth<uint16_t>(endsInOne);
+    BOOST_CHECK( narrowEndsInOne.GetSimulationMode() == SimulationMode::BitParallel );
+    
+    std::vector<unsigned int> word {0, 1};
+    BOOST_CHECK( narrowEndsInOne.contains(word.begin(), word.end()) );
+    for(unsigned int number = 0; number < 256; number++) {
+        BOOST_CHECK( narrow.contains(number) == language.contains(number) );
+        BOOST_CHECK( narrowEndsInOne.contains(number) == endsInOne.contains(number) );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
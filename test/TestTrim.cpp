@@ -0,0 +1,216 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Trim.hpp"
+#include "utils/DecidedStates.hpp"
+#include <memory>
+#include <vector>
+
+using namespace FACore;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE( TestTrim );
+
+BOOST_AUTO_TEST_CASE( deterministic_decided_states )
+{
+    DAutomaton<3> dfa;
+    auto start = dfa.AddState(false);
+    auto dead = dfa.AddState(false);
+    auto accepting = dfa.AddState(true);
+    auto finalOnly = dfa.AddState(true);
+    dfa.SetArc(start, 0, dead);
+    dfa.SetArc(start, 1, accepting);
+    dfa.SetArc(start, 2, finalOnly);
+    dfa.SetArc(dead, 0, dead);
+    for(unsigned int label = 0; label < 3; label++) {
+        dfa.SetArc(accepting, label, accepting);
+    }
+    dfa.SetArc(finalOnly, 0, accepting);
+    dfa.SetArc(finalOnly, 1, accepting);
+    
+    DecidedStates decided = FindDecidedStates(dfa);
+    BOOST_CHECK( decided.dead[dead] && !decided.dead[start] && !decided.dead[finalOnly] );
+    BOOST_CHECK( decided.accepting[accepting] );
+    // finalOnly has no arc for 2, so it is not accepting
+    BOOST_CHECK( !decided.accepting[finalOnly] && !decided.accepting[start] );
+}
+
+BOOST_AUTO_TEST_CASE( deterministic_early_exit )
+{
+    typedef DRegularLanguage<2, unsigned int, CountingInstrumentation> Language;
+    
+    // Words that start with 1, a 0 first leads to a dead state with a self loop
+    shared_ptr<DFA> dfa( new DFA() );
+    auto start = dfa->AddState(false);
+    auto dead = dfa->AddState(false);
+    auto accepting = dfa->AddState(true);
+    dfa->SetArc(start, 0, dead);
+    dfa->SetArc(start, 1, accepting);
+    dfa->SetArc(dead, 0, dead);
+    dfa->SetArc(dead, 1, dead);
+    dfa->SetArc(accepting, 0, accepting);
+    dfa->SetArc(accepting, 1, accepting);
+    
+    Language language(dfa, start);
+    vector<unsigned int> rejected = {0, 1, 1, 1};
+    vector<unsigned int> accepted = {1, 0, 0, 0};
+    BOOST_CHECK( !language.contains(rejected.begin(), rejected.end()) );
+    BOOST_CHECK( language.contains(accepted.begin(), accepted.end()) );
+    BOOST_CHECK( language.GetInstrumentation().GetNumCharacters() == 2 );
+    BOOST_CHECK( language.GetInstrumentation().GetNumEarlyExits() == 2 );
+}
+
+BOOST_AUTO_TEST_CASE( nondeterministic_early_exit )
+{
+    typedef NRegularLanguage<2, unsigned int, CountingInstrumentation> Language;
+    
+    // Words containing 1 1, with a dead branch on every 0
+    shared_ptr<NFA> nfa( new NFA() );
+    auto start = nfa->AddState(false);
+    auto seenOne = nfa->AddState(false);
+    auto done = nfa->AddState(false);
+    auto doneFinal = nfa->AddState(true);
+    auto dead = nfa->AddState(false);
+    nfa->AddArc(start, 0, start);
+    nfa->AddArc(start, 1, start);
+    nfa->AddArc(start, 1, seenOne);
+    nfa->AddArc(start, 0, dead);
+    nfa->AddArc(seenOne, 1, done);
+    nfa->AddEpsilonArc(done, doneFinal);
+    nfa->AddArc(doneFinal, 0, done);
+    nfa->AddArc(doneFinal, 1, done);
+    nfa->AddArc(dead, 0, dead);
+    
+    vector<unsigned int> word = {0, 1, 1, 0, 0, 0};
+    vector<unsigned int> noPair = {0, 1, 0, 1, 0};
+    for(SimulationMode mode : {SimulationMode::StateSet, SimulationMode::BitParallel, SimulationMode::LazyDFA}) {
+        Language language(nfa, {start}, mode);
+        // The dead state never joins the active states
+        BOOST_CHECK( !language.contains(noPair.begin(), noPair.end()) );
+        BOOST_CHECK( language.GetInstrumentation().GetPeakActiveStates() == 2 );
+        BOOST_CHECK( language.GetInstrumentation().GetNumEarlyExits() == 0 );
+        
+        language.GetInstrumentation().Reset();
+        BOOST_CHECK( language.contains(word.begin(), word.end()) );
+        BOOST_CHECK( language.GetInstrumentation().GetNumCharacters() == 3 );
+        BOOST_CHECK( language.GetInstrumentation().GetNumEarlyExits() == 1 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( invalid_label_after_accepting_prefix )
+{
+    shared_ptr<DFA> dfa( new DFA() );
+    auto all = dfa->AddState(true);
+    dfa->SetArc(all, 0, all);
+    dfa->SetArc(all, 1, all);
+    DRegularLanguage<2> language(dfa, all);
+    
+    shared_ptr<NFA> nfa( new NFA() );
+    auto nAll = nfa->AddState(true);
+    nfa->AddArc(nAll, 0, nAll);
+    nfa->AddArc(nAll, 1, nAll);
+    
+    vector<unsigned int> invalid = {0, 7};
+    vector<unsigned int> valid = {0, 1};
+    BOOST_CHECK( !language.contains(invalid.begin(), invalid.end()) );
+    BOOST_CHECK( language.contains(valid.begin(), valid.end()) );
+    for(SimulationMode mode : {SimulationMode::StateSet, SimulationMode::BitParallel, SimulationMode::LazyDFA}) {
+        NRegularLanguage<2> nfaLanguage(nfa, {nAll}, mode);
+        BOOST_CHECK( !nfaLanguage.contains(invalid.begin(), invalid.end()) );
+        BOOST_CHECK( nfaLanguage.contains(valid.begin(), valid.end()) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( automaton_changed_after_query )
+{
+    // Dead until the arc to a final state is added, after the first query
+    DFA *dfa = new DFA();
+    auto start = dfa->AddState(false);
+    dfa->SetArc(start, 0, start);
+    DRegularLanguage<2> language(dfa, start);
+    
+    vector<unsigned int> word = {0, 1};
+    BOOST_CHECK( !language.contains(word.begin(), word.end()) );
+    auto accept = dfa->AddState(true);
+    dfa->SetArc(start, 1, accept);
+    BOOST_CHECK( language.contains(word.begin(), word.end()) );
+    
+    for(SimulationMode mode : {SimulationMode::StateSet, SimulationMode::BitParallel, SimulationMode::LazyDFA}) {
+        shared_ptr<NFA> nfa( new NFA() );
+        auto nStart = nfa->AddState(false);
+        nfa->AddArc(nStart, 0, nStart);
+        NRegularLanguage<2> nfaLanguage(nfa, {nStart}, mode);
+        
+        BOOST_CHECK( !nfaLanguage.contains(word.begin(), word.end()) );
+        auto nAccept = nfa->AddState(true);
+        auto epsilon = nfa->AddState(false);
+        nfa->AddArc(nStart, 1, epsilon);
+        nfa->AddEpsilonArc(epsilon, nAccept);
+        BOOST_CHECK( nfaLanguage.contains(word.begin(), word.end()) );
+        BOOST_CHECK( !nfaLanguage.GetEpsilonClosure()->IsTrivial() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( trim_deterministic )
+{
+    DFA dfa;
+    auto unreachable = dfa.AddState(true);
+    auto start = dfa.AddState(false);
+    auto dead = dfa.AddState(false);
+    auto accept = dfa.AddState(true);
+    dfa.SetArc(unreachable, 0, start);
+    dfa.SetArc(start, 0, dead);
+    dfa.SetArc(start, 1, accept);
+    dfa.SetArc(dead, 1, dead);
+    dfa.SetArc(accept, 0, start);
+    
+    auto result = Trim(dfa, start);
+    BOOST_CHECK( result.removedStates == 2 );
+    BOOST_CHECK( result.automaton.GetNumStates() == 2 );
+    BOOST_CHECK( result.initialState == 0 );
+    BOOST_CHECK( result.automaton.GetNext(0, 0) == DFA::INVALID_STATE );
+    BOOST_CHECK( result.automaton.GetNext(0, 1) == 1 );
+    BOOST_CHECK( result.automaton.GetNext(1, 0) == 0 );
+    BOOST_CHECK( result.automaton.IsFinal(1) );
+    
+    // Nothing accepted from dead
+    auto empty = Trim(dfa, dead);
+    BOOST_CHECK( empty.initialState == DFA::INVALID_STATE );
+    BOOST_CHECK( empty.automaton.GetNumStates() == 0 );
+    BOOST_CHECK( empty.removedStates == 4 );
+}
+
+BOOST_AUTO_TEST_CASE( trim_nondeterministic_keeps_language )
+{
+    shared_ptr<NFA> nfa( new NFA() );
+    auto unreachable = nfa->AddState(true);
+    auto start = nfa->AddState(false);
+    auto middle = nfa->AddState(false);
+    auto accept = nfa->AddState(true);
+    auto dead = nfa->AddState(false);
+    nfa->AddArc(unreachable, 0, start);
+    nfa->AddArc(start, 0, dead);
+    nfa->AddArc(start, 1, middle);
+    nfa->AddEpsilonArc(middle, accept);
+    nfa->AddArc(accept, 0, start);
+    nfa->AddEpsilonArc(accept, dead);
+    
+    NRegularLanguage<2> language(nfa, {start, dead});
+    NRegularLanguage<2> trimmed = Trim(language);
+    BOOST_CHECK( trimmed.GetAutomaton()->GetNumStates() == 3 );
+    BOOST_CHECK( trimmed.GetInitialStates() == set<unsigned int>({0}) );
+    BOOST_CHECK( trimmed.GetAutomaton()->GetNumEpsilonArcs() == 1 );
+    
+    vector<unsigned int> word;
+    for(unsigned int length = 0; length <= 8; length++) {
+        for(unsigned int bits = 0; bits < (1u << length); bits++) {
+            word.clear();
+            for(unsigned int i = 0; i < length; i++) {
+                word.push_back((bits >> i) & 1);
+            }
+            BOOST_CHECK( trimmed.contains(word.begin(), word.end()) == language.contains(word.begin(), word.end()) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file